@@ -14,6 +14,7 @@ class WAParam {
   final double _maxValue;
 
   double _value;
+  WAAutomationRate _automationRate;
 
   /// Creates a new AudioParameter.
   WAParam({
@@ -23,13 +24,14 @@ class WAParam {
     double defaultValue = 0.0,
     double minValue = -3.4028235e38,
     double maxValue = 3.4028235e38,
-    this.automationRate = WAAutomationRate.aRate,
+    WAAutomationRate automationRate = WAAutomationRate.aRate,
   })  : _contextId = contextId,
         _nodeId = nodeId,
         _paramName = paramName,
         _defaultValue = defaultValue,
         _minValue = minValue,
         _maxValue = maxValue,
+        _automationRate = automationRate,
         _value = defaultValue;
 
   // ---------------------------------------------------------------------------
@@ -62,7 +64,16 @@ class WAParam {
   double get maxValue => _maxValue;
 
   /// Whether this parameter is a-rate (per-sample) or k-rate (per-block).
-  WAAutomationRate automationRate;
+  ///
+  /// Params whose rate the spec fixes, such as the compressor params and a
+  /// buffer source's `playbackRate` and `detune`, keep their rate.
+  WAAutomationRate get automationRate => _automationRate;
+  set automationRate(WAAutomationRate rate) {
+    if (backend.paramSetAutomationRate(
+        _nodeId, _paramName, rate == WAAutomationRate.kRate)) {
+      _automationRate = rate;
+    }
+  }
 
   // ---------------------------------------------------------------------------
   // Automation Methods — P1
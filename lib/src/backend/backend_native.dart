@@ -51,6 +51,8 @@ typedef _CtxSetPreferredSampleRateN = ffi.Int32 Function(ffi.Int32, ffi.Double);
 typedef _CtxSetPreferredSampleRateD = int Function(int, double);
 typedef _CtxSetPreferredBitDepthN = ffi.Int32 Function(ffi.Int32, ffi.Int32);
 typedef _CtxSetPreferredBitDepthD = int Function(int, int);
+typedef _CtxSetRenderThreadsN = ffi.Int32 Function(ffi.Int32, ffi.Int32);
+typedef _CtxSetRenderThreadsD = int Function(int, int);
 typedef _CtxRenderN = ffi.Int32 Function(
     ffi.Int32, ffi.Pointer<ffi.Float>, ffi.Int32, ffi.Int32);
 typedef _CtxRenderD = int Function(int, ffi.Pointer<ffi.Float>, int, int);
@@ -96,34 +98,29 @@ typedef _RemoveNodeN = ffi.Void Function(ffi.Int32, ffi.Int32);
 typedef _RemoveNodeD = void Function(int, int);
 
 // Params
-typedef _ParamSetN = ffi.Void Function(
-    ffi.Int32, ffi.Pointer<ffi.Char>, ffi.Float);
-typedef _ParamSetD = void Function(int, ffi.Pointer<ffi.Char>, double);
+typedef _ParamGetIndexN = ffi.Int32 Function(ffi.Int32, ffi.Pointer<ffi.Char>);
+typedef _ParamGetIndexD = int Function(int, ffi.Pointer<ffi.Char>);
+typedef _ParamSetN = ffi.Void Function(ffi.Int32, ffi.Int32, ffi.Float);
+typedef _ParamSetD = void Function(int, int, double);
 typedef _ParamSetAtTimeN = ffi.Void Function(
-    ffi.Int32, ffi.Pointer<ffi.Char>, ffi.Float, ffi.Double);
-typedef _ParamSetAtTimeD = void Function(
-    int, ffi.Pointer<ffi.Char>, double, double);
+    ffi.Int32, ffi.Int32, ffi.Float, ffi.Double);
+typedef _ParamSetAtTimeD = void Function(int, int, double, double);
 typedef _ParamRampN = ffi.Void Function(
-    ffi.Int32, ffi.Pointer<ffi.Char>, ffi.Float, ffi.Double);
-typedef _ParamRampD = void Function(int, ffi.Pointer<ffi.Char>, double, double);
+    ffi.Int32, ffi.Int32, ffi.Float, ffi.Double);
+typedef _ParamRampD = void Function(int, int, double, double);
 typedef _ParamSetTargetN = ffi.Void Function(
-    ffi.Int32, ffi.Pointer<ffi.Char>, ffi.Float, ffi.Double, ffi.Float);
-typedef _ParamSetTargetD = void Function(
-    int, ffi.Pointer<ffi.Char>, double, double, double);
-typedef _ParamSetValueCurveN = ffi.Void Function(
-    ffi.Int32,
-    ffi.Pointer<ffi.Char>,
-    ffi.Pointer<ffi.Float>,
-    ffi.Int32,
-    ffi.Double,
-    ffi.Double);
+    ffi.Int32, ffi.Int32, ffi.Float, ffi.Double, ffi.Float);
+typedef _ParamSetTargetD = void Function(int, int, double, double, double);
+typedef _ParamSetValueCurveN = ffi.Void Function(ffi.Int32, ffi.Int32,
+    ffi.Pointer<ffi.Float>, ffi.Int32, ffi.Double, ffi.Double);
 typedef _ParamSetValueCurveD = void Function(
-    int, ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Float>, int, double, double);
-typedef _ParamCancelN = ffi.Void Function(
-    ffi.Int32, ffi.Pointer<ffi.Char>, ffi.Double);
-typedef _ParamCancelD = void Function(int, ffi.Pointer<ffi.Char>, double);
-typedef _ParamGetN = ffi.Float Function(ffi.Int32, ffi.Pointer<ffi.Char>);
-typedef _ParamGetD = double Function(int, ffi.Pointer<ffi.Char>);
+    int, int, ffi.Pointer<ffi.Float>, int, double, double);
+typedef _ParamCancelN = ffi.Void Function(ffi.Int32, ffi.Int32, ffi.Double);
+typedef _ParamCancelD = void Function(int, int, double);
+typedef _ParamGetN = ffi.Float Function(ffi.Int32, ffi.Int32);
+typedef _ParamGetD = double Function(int, int);
+typedef _ParamSetRateN = ffi.Int32 Function(ffi.Int32, ffi.Int32, ffi.Int32);
+typedef _ParamSetRateD = int Function(int, int, int);
 
 // Osc
 typedef _OscSetTypeN = ffi.Void Function(ffi.Int32, ffi.Int32);
@@ -182,6 +179,8 @@ typedef _BiquadGetFrequencyResponseD = void Function(
     int);
 typedef _CompressorGetReductionN = ffi.Float Function(ffi.Int32);
 typedef _CompressorGetReductionD = double Function(int);
+typedef _CompressorSetLookaheadN = ffi.Void Function(ffi.Int32, ffi.Double);
+typedef _CompressorSetLookaheadD = void Function(int, double);
 typedef _PannerSetIntN = ffi.Void Function(ffi.Int32, ffi.Int32);
 typedef _PannerSetIntD = void Function(int, int);
 typedef _PannerSetDoubleN = ffi.Void Function(ffi.Int32, ffi.Double);
@@ -273,6 +272,9 @@ final _contextSetPreferredSampleRate = _lib.lookupFunction<
 final _contextSetPreferredBitDepth =
     _lib.lookupFunction<_CtxSetPreferredBitDepthN, _CtxSetPreferredBitDepthD>(
         'wajuce_context_set_preferred_bit_depth');
+final _contextSetRenderThreads =
+    _lib.lookupFunction<_CtxSetRenderThreadsN, _CtxSetRenderThreadsD>(
+        'wajuce_context_set_render_threads');
 final _contextGetState =
     _lib.lookupFunction<_CtxIntN, _CtxIntD>('wajuce_context_get_state');
 final _contextResume =
@@ -379,25 +381,29 @@ final _removeNode = _lib
     .lookupFunction<_RemoveNodeN, _RemoveNodeD>('wajuce_context_remove_node');
 
 // Params
-final _paramSet =
-    _lib.lookupFunction<_ParamSetN, _ParamSetD>('wajuce_param_set');
+final _paramGetIndex = _lib.lookupFunction<_ParamGetIndexN, _ParamGetIndexD>(
+    'wajuce_param_get_index');
+final _paramSet = _lib.lookupFunction<_ParamSetN, _ParamSetD>(
+    'wajuce_param_set_by_index');
 final _paramSetAtTime = _lib.lookupFunction<_ParamSetAtTimeN, _ParamSetAtTimeD>(
-    'wajuce_param_set_at_time');
-final _paramLinearRamp =
-    _lib.lookupFunction<_ParamRampN, _ParamRampD>('wajuce_param_linear_ramp');
-final _paramExpRamp =
-    _lib.lookupFunction<_ParamRampN, _ParamRampD>('wajuce_param_exp_ramp');
+    'wajuce_param_set_at_time_by_index');
+final _paramLinearRamp = _lib.lookupFunction<_ParamRampN, _ParamRampD>(
+    'wajuce_param_linear_ramp_by_index');
+final _paramExpRamp = _lib.lookupFunction<_ParamRampN, _ParamRampD>(
+    'wajuce_param_exp_ramp_by_index');
 final _paramSetTarget = _lib.lookupFunction<_ParamSetTargetN, _ParamSetTargetD>(
-    'wajuce_param_set_target');
+    'wajuce_param_set_target_by_index');
 final _paramSetValueCurve =
     _lib.lookupFunction<_ParamSetValueCurveN, _ParamSetValueCurveD>(
-        'wajuce_param_set_value_curve');
-final _paramCancel =
-    _lib.lookupFunction<_ParamCancelN, _ParamCancelD>('wajuce_param_cancel');
+        'wajuce_param_set_value_curve_by_index');
+final _paramCancel = _lib.lookupFunction<_ParamCancelN, _ParamCancelD>(
+    'wajuce_param_cancel_by_index');
 final _paramCancelAndHold = _lib.lookupFunction<_ParamCancelN, _ParamCancelD>(
-    'wajuce_param_cancel_and_hold');
-final _paramGet =
-    _lib.lookupFunction<_ParamGetN, _ParamGetD>('wajuce_param_get');
+    'wajuce_param_cancel_and_hold_by_index');
+final _paramGet = _lib.lookupFunction<_ParamGetN, _ParamGetD>(
+    'wajuce_param_get_by_index');
+final _paramSetRate = _lib.lookupFunction<_ParamSetRateN, _ParamSetRateD>(
+    'wajuce_param_set_automation_rate_by_index');
 
 // Osc
 final _oscSetType =
@@ -462,6 +468,9 @@ final _iirGetFrequencyResponse = _lib.lookupFunction<
 final _compressorGetReduction =
     _lib.lookupFunction<_CompressorGetReductionN, _CompressorGetReductionD>(
         'wajuce_compressor_get_reduction');
+final _compressorSetLookahead =
+    _lib.lookupFunction<_CompressorSetLookaheadN, _CompressorSetLookaheadD>(
+        'wajuce_compressor_set_lookahead');
 final _pannerSetPanningModel =
     _lib.lookupFunction<_PannerSetIntN, _PannerSetIntD>(
         'wajuce_panner_set_panning_model');
@@ -605,6 +614,8 @@ void contextDestroy(int ctxId) {
   _contextBufferSizes.remove(ctxId);
   _contextSampleRates.remove(ctxId);
   _contextOutputChannels.remove(ctxId);
+  // A new context hands out the same node ids again.
+  _paramIndices.clear();
   _contextDestroy(ctxId);
 }
 
@@ -626,6 +637,8 @@ bool contextSetPreferredSampleRate(int ctxId, double sampleRate) {
 
 bool contextSetPreferredBitDepth(int ctxId, int bitDepth) =>
     _contextSetPreferredBitDepth(ctxId, bitDepth) != 0;
+bool contextSetRenderThreads(int ctxId, int workerThreads) =>
+    _contextSetRenderThreads(ctxId, workerThreads) != 0;
 int contextGetState(int ctxId) => _contextGetState(ctxId);
 void contextResume(int ctxId) => _contextResume(ctxId);
 void contextSuspend(int ctxId) => _contextSuspend(ctxId);
@@ -789,6 +802,7 @@ void removeNode(int ctxId, int nodeId) {
   _bufferSourceLoopStarts.remove(nodeId);
   _bufferSourceLoopEnds.remove(nodeId);
   _convolverNormalize.remove(nodeId);
+  _paramIndices.remove(nodeId);
   _removeNode(ctxId, nodeId);
 }
 
@@ -796,22 +810,45 @@ void removeNode(int ctxId, int nodeId) {
 // Backend API — AudioParam
 // ---------------------------------------------------------------------------
 
+// Param slots are fixed for a node's lifetime, so each name is marshalled
+// once per node and later calls go through the index-based entry points.
+final Map<int, Map<String, int>> _paramIndices = <int, Map<String, int>>{};
+
+int _paramIndex(int nodeId, String paramName) {
+  final indices = _paramIndices.putIfAbsent(nodeId, () => <String, int>{});
+  final cached = indices[paramName];
+  if (cached != null) {
+    return cached;
+  }
+  final p = _toCString(paramName);
+  final index = _paramGetIndex(nodeId, p);
+  _freeCString(p);
+  if (index >= 0) {
+    indices[paramName] = index;
+  }
+  return index;
+}
+
 void paramSet(int nodeId, String paramName, double value) {
   if (nodeId < 0) {
     return;
   }
-  final p = _toCString(paramName);
-  _paramSet(nodeId, p, value);
-  _freeCString(p);
+  final index = _paramIndex(nodeId, paramName);
+  if (index < 0) {
+    return;
+  }
+  _paramSet(nodeId, index, value);
 }
 
 void paramSetAtTime(int nodeId, String paramName, double value, double time) {
   if (nodeId < 0) {
     return;
   }
-  final p = _toCString(paramName);
-  _paramSetAtTime(nodeId, p, value, time);
-  _freeCString(p);
+  final index = _paramIndex(nodeId, paramName);
+  if (index < 0) {
+    return;
+  }
+  _paramSetAtTime(nodeId, index, value, time);
 }
 
 void paramLinearRamp(
@@ -819,18 +856,22 @@ void paramLinearRamp(
   if (nodeId < 0) {
     return;
   }
-  final p = _toCString(paramName);
-  _paramLinearRamp(nodeId, p, value, endTime);
-  _freeCString(p);
+  final index = _paramIndex(nodeId, paramName);
+  if (index < 0) {
+    return;
+  }
+  _paramLinearRamp(nodeId, index, value, endTime);
 }
 
 void paramExpRamp(int nodeId, String paramName, double value, double endTime) {
   if (nodeId < 0) {
     return;
   }
-  final p = _toCString(paramName);
-  _paramExpRamp(nodeId, p, value, endTime);
-  _freeCString(p);
+  final index = _paramIndex(nodeId, paramName);
+  if (index < 0) {
+    return;
+  }
+  _paramExpRamp(nodeId, index, value, endTime);
 }
 
 void paramSetTarget(
@@ -838,27 +879,33 @@ void paramSetTarget(
   if (nodeId < 0) {
     return;
   }
-  final p = _toCString(paramName);
-  _paramSetTarget(nodeId, p, target, startTime, tc);
-  _freeCString(p);
+  final index = _paramIndex(nodeId, paramName);
+  if (index < 0) {
+    return;
+  }
+  _paramSetTarget(nodeId, index, target, startTime, tc);
 }
 
 void paramCancel(int nodeId, String paramName, double cancelTime) {
   if (nodeId < 0) {
     return;
   }
-  final p = _toCString(paramName);
-  _paramCancel(nodeId, p, cancelTime);
-  _freeCString(p);
+  final index = _paramIndex(nodeId, paramName);
+  if (index < 0) {
+    return;
+  }
+  _paramCancel(nodeId, index, cancelTime);
 }
 
 void paramCancelAndHold(int nodeId, String paramName, double time) {
   if (nodeId < 0) {
     return;
   }
-  final p = _toCString(paramName);
-  _paramCancelAndHold(nodeId, p, time);
-  _freeCString(p);
+  final index = _paramIndex(nodeId, paramName);
+  if (index < 0) {
+    return;
+  }
+  _paramCancelAndHold(nodeId, index, time);
 }
 
 void paramSetValueCurve(int nodeId, String paramName, Float32List values,
@@ -869,23 +916,34 @@ void paramSetValueCurve(int nodeId, String paramName, Float32List values,
   if (values.isEmpty || duration <= 0) {
     return;
   }
-  final p = _toCString(paramName);
+  final index = _paramIndex(nodeId, paramName);
+  if (index < 0) {
+    return;
+  }
   final nativeValues = calloc<ffi.Float>(values.length);
   nativeValues.asTypedList(values.length).setAll(0, values);
   _paramSetValueCurve(
-      nodeId, p, nativeValues, values.length, startTime, duration);
+      nodeId, index, nativeValues, values.length, startTime, duration);
   calloc.free(nativeValues);
-  _freeCString(p);
 }
 
 double paramGet(int nodeId, String paramName) {
   if (nodeId < 0) {
     return 0.0;
   }
-  final p = _toCString(paramName);
-  final value = _paramGet(nodeId, p);
-  _freeCString(p);
-  return value;
+  final index = _paramIndex(nodeId, paramName);
+  return index < 0 ? 0.0 : _paramGet(nodeId, index);
+}
+
+bool paramSetAutomationRate(int nodeId, String paramName, bool kRate) {
+  if (nodeId < 0) {
+    return false;
+  }
+  final index = _paramIndex(nodeId, paramName);
+  if (index < 0) {
+    return false;
+  }
+  return _paramSetRate(nodeId, index, kRate ? 1 : 0) != 0;
 }
 
 // ---------------------------------------------------------------------------
@@ -1041,6 +1099,10 @@ double compressorGetReduction(int nodeId) {
   return _compressorGetReduction(nodeId);
 }
 
+void compressorSetLookahead(int nodeId, double seconds) {
+  _compressorSetLookahead(nodeId, seconds);
+}
+
 void constantSourceStart(int nodeId, double when) {
   _oscStart(nodeId, when);
 }
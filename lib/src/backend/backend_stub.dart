@@ -28,6 +28,7 @@ double contextGetSampleRate(int ctxId) => _unsupported();
 int contextGetBitDepth(int ctxId) => 32;
 bool contextSetPreferredSampleRate(int ctxId, double sampleRate) => false;
 bool contextSetPreferredBitDepth(int ctxId, int bitDepth) => false;
+bool contextSetRenderThreads(int ctxId, int workerThreads) => false;
 int contextGetState(int ctxId) => _unsupported();
 void contextResume(int ctxId) => _unsupported();
 void contextSuspend(int ctxId) => _unsupported();
@@ -122,6 +123,8 @@ void paramSetValueCurve(int nodeId, String paramName, Float32List values,
         double startTime, double duration) =>
     _unsupported();
 double paramGet(int nodeId, String paramName) => _unsupported();
+bool paramSetAutomationRate(int nodeId, String paramName, bool kRate) =>
+    _unsupported();
 
 // ---------------------------------------------------------------------------
 // Oscillator
@@ -175,6 +178,7 @@ void biquadGetFrequencyResponse(int nodeId, Float32List frequencyHz,
     _unsupported();
 
 double compressorGetReduction(int nodeId) => 0.0;
+void compressorSetLookahead(int nodeId, double seconds) => _unsupported();
 
 void constantSourceStart(int nodeId, double when) => _unsupported();
 void constantSourceStop(int nodeId, double when) => _unsupported();
@@ -78,6 +78,7 @@ extension type JSAudioParam._(JSObject _) implements JSObject {
       JSFloat32Array values, JSNumber startTime, JSNumber duration);
   external JSAudioParam cancelScheduledValues(JSNumber startTime);
   external JSAudioParam cancelAndHoldAtTime(JSNumber cancelTime);
+  external set automationRate(JSString rate);
 }
 
 @JS('AudioBuffer')
@@ -245,6 +246,8 @@ bool contextSetPreferredSampleRate(int ctxId, double sampleRate) => false;
 
 bool contextSetPreferredBitDepth(int ctxId, int bitDepth) => false;
 
+bool contextSetRenderThreads(int ctxId, int workerThreads) => false;
+
 int contextGetState(int ctxId) {
   final ctx = _contexts[ctxId];
   if (ctx == null) return 2;
@@ -892,6 +895,18 @@ double paramGet(int nodeId, String paramName) {
   return param?.value.toDartDouble ?? 0.0;
 }
 
+bool paramSetAutomationRate(int nodeId, String paramName, bool kRate) {
+  final param = _getParam(nodeId, paramName);
+  if (param == null) return false;
+  try {
+    param.automationRate = (kRate ? 'k-rate' : 'a-rate').toJS;
+    return true;
+  } catch (_) {
+    // Params with a fixed rate reject the change.
+    return false;
+  }
+}
+
 // ---------------------------------------------------------------------------
 // Backend API — Oscillator
 // ---------------------------------------------------------------------------
@@ -973,6 +988,10 @@ double compressorGetReduction(int nodeId) {
   }
 }
 
+void compressorSetLookahead(int nodeId, double seconds) {
+  // Browsers apply their own fixed lookahead.
+}
+
 void convolverSetBuffer(int nodeId, WABuffer? buffer) {
   final node = _nodes[nodeId];
   if (node == null) return;
@@ -234,6 +234,19 @@ class WAContext {
     return ok;
   }
 
+  /// Render independent branches of the graph on [workerThreads] worker
+  /// threads alongside the audio callback. `0` restores the single-threaded
+  /// renderer.
+  ///
+  /// Output is identical either way. Returns `false` when the backend has no
+  /// parallel renderer.
+  Future<bool> setRenderThreadCount(int workerThreads) async {
+    if (workerThreads < 0) {
+      return false;
+    }
+    return backend.contextSetRenderThreads(_ctxId, workerThreads);
+  }
+
   /// Suspend audio processing.
   Future<void> suspend() async => backend.contextSuspend(_ctxId);
 
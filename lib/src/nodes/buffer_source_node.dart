@@ -1,5 +1,6 @@
 import 'audio_scheduled_source_node.dart';
 import '../audio_param.dart';
+import '../enums.dart';
 import '../audio_buffer.dart';
 import '../backend/backend.dart' as backend;
 
@@ -32,6 +33,7 @@ class WABufferSourceNode extends WAScheduledSourceNode {
       defaultValue: 1.0,
       minValue: -3.4028235e38,
       maxValue: 3.4028235e38,
+      automationRate: WAAutomationRate.kRate,
     );
     detune = WAParam(
       contextId: contextId,
@@ -40,6 +42,7 @@ class WABufferSourceNode extends WAScheduledSourceNode {
       defaultValue: 0.0,
       minValue: -153600.0,
       maxValue: 153600.0,
+      automationRate: WAAutomationRate.kRate,
     );
     decay = WAParam(
       contextId: contextId,
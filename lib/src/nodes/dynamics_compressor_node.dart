@@ -1,5 +1,6 @@
 import 'audio_node.dart';
 import '../audio_param.dart';
+import '../enums.dart';
 import '../backend/backend.dart' as backend;
 
 /// A dynamics compressor node. Mirrors Web Audio API DynamicsCompressorNode.
@@ -19,6 +20,8 @@ class WADynamicsCompressorNode extends WANode {
   /// The time in seconds to release gain.
   late final WAParam release;
 
+  double _lookahead = 0.0;
+
   /// Creates a new DynamicsCompressorNode.
   WADynamicsCompressorNode({
     required super.nodeId,
@@ -31,6 +34,7 @@ class WADynamicsCompressorNode extends WANode {
       defaultValue: -24.0,
       minValue: -100.0,
       maxValue: 0.0,
+      automationRate: WAAutomationRate.kRate,
     );
     knee = WAParam(
       contextId: contextId,
@@ -39,6 +43,7 @@ class WADynamicsCompressorNode extends WANode {
       defaultValue: 30.0,
       minValue: 0.0,
       maxValue: 40.0,
+      automationRate: WAAutomationRate.kRate,
     );
     ratio = WAParam(
       contextId: contextId,
@@ -47,6 +52,7 @@ class WADynamicsCompressorNode extends WANode {
       defaultValue: 12.0,
       minValue: 1.0,
       maxValue: 20.0,
+      automationRate: WAAutomationRate.kRate,
     );
     attack = WAParam(
       contextId: contextId,
@@ -55,6 +61,7 @@ class WADynamicsCompressorNode extends WANode {
       defaultValue: 0.003,
       minValue: 0.0,
       maxValue: 1.0,
+      automationRate: WAAutomationRate.kRate,
     );
     release = WAParam(
       contextId: contextId,
@@ -63,6 +70,7 @@ class WADynamicsCompressorNode extends WANode {
       defaultValue: 0.25,
       minValue: 0.0,
       maxValue: 1.0,
+      automationRate: WAAutomationRate.kRate,
     );
   }
 
@@ -74,4 +82,13 @@ class WADynamicsCompressorNode extends WANode {
 
   /// Current gain reduction in dB (read-only).
   double get reduction => backend.compressorGetReduction(nodeId);
+
+  /// Seconds the output trails the level detector, up to 0.1, so gain
+  /// reduction is already applied when a transient arrives. Native only;
+  /// browsers use their own fixed lookahead.
+  double get lookahead => _lookahead;
+  set lookahead(double seconds) {
+    _lookahead = seconds;
+    backend.compressorSetLookahead(nodeId, seconds);
+  }
 }
@@ -0,0 +1,256 @@
+#pragma once
+/**
+ * Convolver.h — Zero-latency partitioned convolution.
+ * The first block of an impulse response is applied directly; the rest runs
+ * as uniformly partitioned overlap-save convolution in the frequency domain.
+ */
+
+#include "FFT.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace wajuce {
+
+// An impulse response split for PartitionedConvolver. Built off the render
+// thread and immutable afterwards, so one kernel can back several convolvers.
+class ConvolverKernel {
+public:
+  static constexpr int kBlock = 128;
+
+  // ir is planar: channel c starts at ir + c * frames. Non-finite taps are
+  // treated as zero.
+  ConvolverKernel(const float *ir, int frames, int channels)
+      : frameCount(std::max(0, frames)), channelCount(std::max(0, channels)),
+        headLength(std::min(frameCount, kBlock)),
+        partitionCount((std::max(0, frameCount - kBlock) + kBlock - 1) /
+                       kBlock),
+        transform(2 * kBlock) {
+    const auto tap = [&](int ch, int i) {
+      const float v = ir[static_cast<size_t>(ch) * frameCount + i];
+      return std::isfinite(v) ? v : 0.0f;
+    };
+    heads.resize(static_cast<size_t>(channelCount));
+    partitions.resize(static_cast<size_t>(channelCount));
+    std::vector<float> segment(static_cast<size_t>(2 * kBlock));
+    for (int ch = 0; ch < channelCount; ++ch) {
+      auto &head = heads[static_cast<size_t>(ch)];
+      head.resize(static_cast<size_t>(headLength));
+      for (int i = 0; i < headLength; ++i) {
+        head[static_cast<size_t>(i)] = tap(ch, i);
+      }
+      auto &spectra = partitions[static_cast<size_t>(ch)];
+      spectra.resize(static_cast<size_t>(partitionCount) * kBins);
+      for (int p = 0; p < partitionCount; ++p) {
+        std::fill(segment.begin(), segment.end(), 0.0f);
+        const int first = kBlock + p * kBlock;
+        const int count = std::min(kBlock, frameCount - first);
+        for (int i = 0; i < count; ++i) {
+          segment[static_cast<size_t>(i)] = tap(ch, first + i);
+        }
+        transform.forward(segment.data(),
+                          spectra.data() + static_cast<size_t>(p) * kBins);
+      }
+    }
+  }
+
+  int frames() const { return frameCount; }
+  int channels() const { return channelCount; }
+
+private:
+  friend class PartitionedConvolver;
+  static constexpr size_t kBins = kBlock + 1;
+
+  int frameCount;
+  int channelCount;
+  int headLength;
+  int partitionCount;
+  RealFFT<float> transform;
+  std::vector<std::vector<float>> heads;
+  std::vector<std::vector<std::complex<float>>> partitions;
+};
+
+// Streaming convolution of a kernel over a fixed number of channels. Routing
+// follows ConvolverNode: one- and two-channel responses filter each channel
+// by the matching (or only) response channel, and four-channel responses are
+// true stereo, mixing left and right through LL, LR, RL and RR.
+class PartitionedConvolver {
+public:
+  // Allocates; call off the render thread where possible.
+  void prepare(std::shared_ptr<const ConvolverKernel> nextKernel,
+               int nextChannels) {
+    kernel = std::move(nextKernel);
+    channels = std::max(0, nextChannels);
+    paths.clear();
+    streams = 0;
+    if (!kernel || kernel->channels() <= 0 || channels <= 0) {
+      return;
+    }
+    const int irChannels = kernel->channels();
+    if (irChannels >= 4) {
+      streams = 2;
+      for (int out = 0; out < std::min(channels, 2); ++out) {
+        paths.push_back({0, out, out});
+        paths.push_back({1, 2 + out, out});
+      }
+    } else {
+      streams = channels;
+      for (int ch = 0; ch < channels; ++ch) {
+        paths.push_back({ch, std::min(ch, irChannels - 1), ch});
+      }
+    }
+
+    const auto bins = ConvolverKernel::kBins;
+    const auto partitionCount = static_cast<size_t>(kernel->partitionCount);
+    frames.assign(static_cast<size_t>(streams),
+                  std::vector<float>(2 * ConvolverKernel::kBlock, 0.0f));
+    history.assign(static_cast<size_t>(streams),
+                   std::vector<std::complex<float>>(partitionCount * bins));
+    tails.assign(static_cast<size_t>(channels),
+                 std::vector<float>(ConvolverKernel::kBlock, 0.0f));
+    spectrum.assign(bins, std::complex<float>());
+    block.assign(2 * ConvolverKernel::kBlock, 0.0f);
+    newest = 0;
+    position = 0;
+  }
+
+  int channelCount() const { return channels; }
+
+  bool preparedFor(const ConvolverKernel *candidate, int count) const {
+    return kernel.get() == candidate && channels == count;
+  }
+
+  // inputs and outputs hold one pointer per channel. Stream inputs past the
+  // channel count reuse the last channel, so mono feeds true stereo.
+  void process(const float *const *inputs, float *const *outputs,
+               int frameCount) {
+    for (int ch = 0; ch < channels; ++ch) {
+      std::fill(outputs[ch], outputs[ch] + frameCount, 0.0f);
+    }
+    if (paths.empty()) {
+      return;
+    }
+    constexpr int kBlock = ConvolverKernel::kBlock;
+    int done = 0;
+    while (done < frameCount) {
+      const int count = std::min(frameCount - done, kBlock - position);
+      for (int s = 0; s < streams; ++s) {
+        const float *in = inputs[std::min(s, channels - 1)] + done;
+        std::copy(in, in + count,
+                  frames[static_cast<size_t>(s)].begin() + kBlock + position);
+      }
+      for (int ch = 0; ch < channels; ++ch) {
+        const float *tail = tails[static_cast<size_t>(ch)].data() + position;
+        std::copy(tail, tail + count, outputs[ch] + done);
+      }
+      const int taps = kernel->headLength;
+      for (const auto &path : paths) {
+        const float *h = kernel->heads[static_cast<size_t>(path.ir)].data();
+        const float *x =
+            frames[static_cast<size_t>(path.stream)].data() + kBlock + position;
+        float *out = outputs[path.output] + done;
+        for (int i = 0; i < count; ++i) {
+          float sum = 0.0f;
+          for (int m = 0; m < taps; ++m) {
+            sum += h[m] * x[i - m];
+          }
+          out[i] += sum;
+        }
+      }
+      position += count;
+      done += count;
+      if (position == kBlock) {
+        runTail();
+        position = 0;
+      }
+    }
+  }
+
+private:
+  struct Path {
+    int stream;
+    int ir;
+    int output;
+  };
+
+  // Runs once per completed block: transforms the last two blocks of each
+  // stream and produces the tail contribution for the next block.
+  void runTail() {
+    constexpr int kBlock = ConvolverKernel::kBlock;
+    const auto bins = ConvolverKernel::kBins;
+    const int partitionCount = kernel->partitionCount;
+    if (partitionCount > 0) {
+      newest = newest == 0 ? partitionCount - 1 : newest - 1;
+      for (int s = 0; s < streams; ++s) {
+        auto &frame = frames[static_cast<size_t>(s)];
+        kernel->transform.forward(
+            frame.data(), history[static_cast<size_t>(s)].data() +
+                              static_cast<size_t>(newest) * bins);
+      }
+      for (int ch = 0; ch < channels; ++ch) {
+        std::fill(spectrum.begin(), spectrum.end(), std::complex<float>());
+        bool used = false;
+        for (const auto &path : paths) {
+          if (path.output != ch) {
+            continue;
+          }
+          used = true;
+          const auto &spectra = history[static_cast<size_t>(path.stream)];
+          const auto &kernelSpectra =
+              kernel->partitions[static_cast<size_t>(path.ir)];
+          for (int p = 0; p < partitionCount; ++p) {
+            const int slot = (newest + p) % partitionCount;
+            multiplyAccumulate(
+                spectra.data() + static_cast<size_t>(slot) * bins,
+                kernelSpectra.data() + static_cast<size_t>(p) * bins,
+                spectrum.data(), bins);
+          }
+        }
+        auto &tail = tails[static_cast<size_t>(ch)];
+        if (!used) {
+          std::fill(tail.begin(), tail.end(), 0.0f);
+          continue;
+        }
+        kernel->transform.inverse(spectrum.data(), block.data());
+        std::copy(block.begin() + kBlock, block.end(), tail.begin());
+      }
+    }
+    for (auto &frame : frames) {
+      std::copy(frame.begin() + kBlock, frame.end(), frame.begin());
+    }
+  }
+
+  static void multiplyAccumulate(const std::complex<float> *x,
+                                 const std::complex<float> *h,
+                                 std::complex<float> *acc, size_t bins) {
+    for (size_t k = 0; k < bins; ++k) {
+      const float xr = x[k].real();
+      const float xi = x[k].imag();
+      const float hr = h[k].real();
+      const float hi = h[k].imag();
+      acc[k] = std::complex<float>(acc[k].real() + xr * hr - xi * hi,
+                                   acc[k].imag() + xr * hi + xi * hr);
+    }
+  }
+
+  std::shared_ptr<const ConvolverKernel> kernel;
+  int channels = 0;
+  int streams = 0;
+  std::vector<Path> paths;
+  // Per stream: the previous and current input blocks, and the spectra of
+  // past frames with the newest at index `newest`.
+  std::vector<std::vector<float>> frames;
+  std::vector<std::vector<std::complex<float>>> history;
+  // Per output channel: the tail contribution for the block being filled.
+  std::vector<std::vector<float>> tails;
+  std::vector<std::complex<float>> spectrum;
+  std::vector<float> block;
+  int newest = 0;
+  int position = 0;
+};
+
+} // namespace wajuce
@@ -0,0 +1,163 @@
+#pragma once
+/**
+ * FFT.h — Radix-2 fast Fourier transform.
+ * Twiddles and the bit-reversal order are prepared once per size, so each
+ * transform only runs the butterflies.
+ */
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace wajuce {
+
+template <typename T> class FFT {
+public:
+  using Complex = std::complex<T>;
+
+  // size must be a power of two.
+  explicit FFT(int size)
+      : n(size), twiddles(static_cast<size_t>(size / 2)),
+        reversed(static_cast<size_t>(size)) {
+    constexpr double pi = 3.14159265358979323846264338327950288;
+    for (int k = 0; k < n / 2; ++k) {
+      const double angle = -2.0 * pi * static_cast<double>(k) / n;
+      twiddles[static_cast<size_t>(k)] =
+          Complex(static_cast<T>(std::cos(angle)),
+                  static_cast<T>(std::sin(angle)));
+    }
+    int bits = 0;
+    while ((1 << bits) < n) {
+      ++bits;
+    }
+    for (int i = 0; i < n; ++i) {
+      int r = 0;
+      for (int b = 0; b < bits; ++b) {
+        r |= ((i >> b) & 1) << (bits - 1 - b);
+      }
+      reversed[static_cast<size_t>(i)] = r;
+    }
+  }
+
+  int size() const { return n; }
+
+  // In place. The forward transform uses e^(-i); the inverse uses e^(+i) and
+  // is left unscaled, so a round trip multiplies by size().
+  void transform(Complex *data, bool inverse) const {
+    for (int i = 0; i < n; ++i) {
+      const int j = reversed[static_cast<size_t>(i)];
+      if (i < j) {
+        std::swap(data[i], data[j]);
+      }
+    }
+    const T sign = inverse ? T(-1) : T(1);
+    for (int len = 2; len <= n; len <<= 1) {
+      const int half = len / 2;
+      const int stride = n / len;
+      for (int start = 0; start < n; start += len) {
+        for (int k = 0; k < half; ++k) {
+          const Complex &w = twiddles[static_cast<size_t>(k * stride)];
+          const T wr = w.real();
+          const T wi = sign * w.imag();
+          Complex &a = data[start + k];
+          Complex &b = data[start + k + half];
+          // Written out to skip std::complex's NaN recovery path.
+          const T br = b.real() * wr - b.imag() * wi;
+          const T bi = b.real() * wi + b.imag() * wr;
+          b = Complex(a.real() - br, a.imag() - bi);
+          a = Complex(a.real() + br, a.imag() + bi);
+        }
+      }
+    }
+  }
+
+private:
+  int n;
+  std::vector<Complex> twiddles;
+  std::vector<int> reversed;
+};
+
+// Real-input transform of a power-of-two size of at least 4, run as a
+// half-size complex FFT over the even/odd samples and then split into the
+// size / 2 + 1 non-negative frequency bins.
+template <typename T> class RealFFT {
+public:
+  using Complex = std::complex<T>;
+
+  explicit RealFFT(int size)
+      : n(size), half(size / 2), twiddles(static_cast<size_t>(size / 4 + 1)) {
+    constexpr double pi = 3.14159265358979323846264338327950288;
+    for (int k = 0; k <= n / 4; ++k) {
+      const double angle = -2.0 * pi * static_cast<double>(k) / n;
+      twiddles[static_cast<size_t>(k)] =
+          Complex(static_cast<T>(std::cos(angle)),
+                  static_cast<T>(std::sin(angle)));
+    }
+  }
+
+  int size() const { return n; }
+
+  // spectrum must hold size() / 2 + 1 bins; it doubles as the work buffer.
+  void forward(const T *input, Complex *spectrum) const {
+    const int m = n / 2;
+    for (int k = 0; k < m; ++k) {
+      spectrum[k] = Complex(input[2 * k], input[2 * k + 1]);
+    }
+    half.transform(spectrum, false);
+
+    const Complex z0 = spectrum[0];
+    spectrum[0] = Complex(z0.real() + z0.imag(), T(0));
+    spectrum[m] = Complex(z0.real() - z0.imag(), T(0));
+    for (int k = 1; k <= m / 2; ++k) {
+      const Complex a = spectrum[k];
+      const Complex b = spectrum[m - k];
+      // Even and odd sample spectra, recovered from the packed transform.
+      const T evenRe = T(0.5) * (a.real() + b.real());
+      const T evenIm = T(0.5) * (a.imag() - b.imag());
+      const T oddRe = T(0.5) * (a.imag() + b.imag());
+      const T oddIm = T(-0.5) * (a.real() - b.real());
+      const Complex &w = twiddles[static_cast<size_t>(k)];
+      const T tr = w.real() * oddRe - w.imag() * oddIm;
+      const T ti = w.real() * oddIm + w.imag() * oddRe;
+      spectrum[k] = Complex(evenRe + tr, evenIm + ti);
+      spectrum[m - k] = Complex(evenRe - tr, ti - evenIm);
+    }
+  }
+
+  // Inverse of forward, scaled so a round trip returns the input. spectrum
+  // holds size() / 2 + 1 bins and is overwritten.
+  void inverse(Complex *spectrum, T *output) const {
+    const int m = n / 2;
+    for (int k = 0; k <= m / 2; ++k) {
+      const Complex a = spectrum[k];
+      const Complex b = spectrum[m - k];
+      // Fold the bins back into the packed even/odd spectrum.
+      const T evenRe = T(0.5) * (a.real() + b.real());
+      const T evenIm = T(0.5) * (a.imag() - b.imag());
+      const T dr = T(0.5) * (a.real() - b.real());
+      const T di = T(0.5) * (a.imag() + b.imag());
+      const Complex &w = twiddles[static_cast<size_t>(k)];
+      const T oddRe = dr * w.real() + di * w.imag();
+      const T oddIm = di * w.real() - dr * w.imag();
+      spectrum[k] = Complex(evenRe - oddIm, evenIm + oddRe);
+      if (k > 0) {
+        spectrum[m - k] = Complex(evenRe + oddIm, oddRe - evenIm);
+      }
+    }
+    half.transform(spectrum, true);
+    const T scale = T(1) / static_cast<T>(m);
+    for (int k = 0; k < m; ++k) {
+      output[2 * k] = spectrum[k].real() * scale;
+      output[2 * k + 1] = spectrum[k].imag() * scale;
+    }
+  }
+
+private:
+  int n;
+  FFT<T> half;
+  std::vector<Complex> twiddles;
+};
+
+} // namespace wajuce
@@ -8,7 +8,8 @@
 #include <atomic>
 #include <cmath>
 #include <cstddef>
-#include <mutex>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 namespace wajuce {
@@ -28,117 +29,285 @@ struct AutomationEvent {
   float value;        // target value
   float timeConstant; // for setTargetAtTime
   double duration = 0.0;
-  std::vector<float> curve;
+  int32_t curve = -1; // value curve handle in the timeline's curve pool
 };
 
+// Time-ordered automation events in a power-of-two ring. Events scheduled in
+// time order append in O(1); others binary-search their slot and shift only
+// the events after it. Retiring past events advances the head. The ring never
+// grows itself: a larger slot array is handed in through adopt().
+class AutomationEventRing {
+public:
+  static constexpr size_t kInitialCapacity = 32;
+
+  AutomationEventRing() : slots(kInitialCapacity) {}
+
+  size_t size() const { return count; }
+  size_t capacity() const { return slots.size(); }
+  bool empty() const { return count == 0; }
+
+  AutomationEvent &operator[](size_t i) {
+    return slots[(head + i) & (slots.size() - 1)];
+  }
+  const AutomationEvent &operator[](size_t i) const {
+    return slots[(head + i) & (slots.size() - 1)];
+  }
+
+  // First index whose event is scheduled after `time`.
+  size_t upperBound(double time) const {
+    size_t lo = 0;
+    size_t hi = count;
+    while (lo < hi) {
+      const size_t mid = lo + (hi - lo) / 2;
+      if ((*this)[mid].time <= time) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  // First index whose event is scheduled at or after `time`.
+  size_t lowerBound(double time) const {
+    size_t lo = 0;
+    size_t hi = count;
+    while (lo < hi) {
+      const size_t mid = lo + (hi - lo) / 2;
+      if ((*this)[mid].time < time) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  // Inserts after any event with the same time, like a stable sort would.
+  // Returns false, dropping the event, when the ring is full.
+  bool insert(const AutomationEvent &event) {
+    if (count == slots.size()) {
+      return false;
+    }
+    size_t at = count;
+    if (count > 0 && (*this)[count - 1].time > event.time) {
+      at = upperBound(event.time);
+    }
+    for (size_t i = count; i > at; --i) {
+      (*this)[i] = (*this)[i - 1];
+    }
+    (*this)[at] = event;
+    ++count;
+    return true;
+  }
+
+  // Moves the events into `next`, a larger power-of-two array, which then
+  // hands the old slots back to the caller.
+  void adopt(std::vector<AutomationEvent> &next) {
+    if (next.size() <= slots.size()) {
+      return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      next[i] = (*this)[i];
+    }
+    slots.swap(next);
+    head = 0;
+  }
+
+  void popFront() {
+    head = (head + 1) & (slots.size() - 1);
+    --count;
+  }
+
+  void popBack() { --count; }
+
+private:
+  std::vector<AutomationEvent> slots;
+  size_t head = 0;
+  size_t count = 0;
+};
+
+// Larger event and curve-pool arrays for a timeline, allocated on the control
+// thread. After ParamTimeline::adoptStorage() it holds the arrays it replaced.
+struct AutomationStorage {
+  std::vector<AutomationEvent> slots;
+  std::vector<std::vector<float>> curves;
+  std::vector<int32_t> freeCurves;
+};
+
+// The event list belongs to the render thread: the engine hands scheduling
+// calls over through its command queue, so a block never waits on, or drops
+// automation because of, the control thread. Only the published value, the
+// automation rate and the event counts behind reserveEvent() are read across
+// threads.
 class ParamTimeline {
 public:
+  ParamTimeline() : curves(AutomationEventRing::kInitialCapacity) {
+    freeCurves.reserve(curves.size());
+    for (size_t i = curves.size(); i > 0; --i) {
+      freeCurves.push_back(static_cast<int32_t>(i - 1));
+    }
+  }
+
+  // Control thread, before posting a command that schedules one event. Every
+  // event owns at most one pooled curve, so both arrays are sized to an upper
+  // bound on the live events: those the render side last reported plus those
+  // still in flight. When that outgrows them, `storage` is filled with larger
+  // arrays, which the command passes to adoptStorage() ahead of the event.
+  void reserveEvent(AutomationStorage &storage) {
+    const uint64_t applied = appliedEvents.load(std::memory_order_acquire);
+    const size_t live = liveEvents.load(std::memory_order_relaxed);
+    const size_t needed =
+        live + static_cast<size_t>(postedEvents - applied) + 1;
+    ++postedEvents;
+    if (needed <= reservedCapacity) {
+      return;
+    }
+    size_t next = reservedCapacity * 2;
+    while (next < needed) {
+      next *= 2;
+    }
+    storage.slots.resize(next);
+    storage.curves.resize(next);
+    storage.freeCurves.reserve(next);
+    reservedCapacity = next;
+  }
+
+  // Render thread: swaps in the arrays from reserveEvent(), moving the events
+  // and pooled curves over. `storage` keeps the old arrays for the control
+  // thread to free.
+  void adoptStorage(AutomationStorage &storage) {
+    if (storage.curves.size() <= curves.size()) {
+      return;
+    }
+    events.adopt(storage.slots);
+    for (size_t i = 0; i < curves.size(); ++i) {
+      storage.curves[i].swap(curves[i]);
+    }
+    storage.freeCurves.assign(freeCurves.begin(), freeCurves.end());
+    for (size_t i = curves.size(); i < storage.curves.size(); ++i) {
+      storage.freeCurves.push_back(static_cast<int32_t>(i));
+    }
+    curves.swap(storage.curves);
+    freeCurves.swap(storage.freeCurves);
+  }
+
   void setValueAtTime(float value, double time) {
-    std::lock_guard<std::mutex> lock(mtx);
     addEvent({AutomationEventType::SetValue, time, value, 0.0f});
   }
 
   void linearRampToValueAtTime(float value, double endTime) {
-    std::lock_guard<std::mutex> lock(mtx);
     addEvent({AutomationEventType::LinearRamp, endTime, value, 0.0f});
   }
 
   void exponentialRampToValueAtTime(float value, double endTime) {
-    std::lock_guard<std::mutex> lock(mtx);
     addEvent({AutomationEventType::ExponentialRamp, endTime, value, 0.0f});
   }
 
   void setTargetAtTime(float target, double startTime, float timeConstant) {
-    std::lock_guard<std::mutex> lock(mtx);
     addEvent({AutomationEventType::SetTarget, startTime, target, timeConstant});
   }
 
-  void setValueCurveAtTime(const float *values, int length, double startTime,
+  // Takes the curve samples by swapping them into a pooled buffer; `values`
+  // comes back holding a retired buffer (or nothing), so whoever owns it
+  // frees that memory instead of the render thread.
+  void setValueCurveAtTime(std::vector<float> &values, double startTime,
                            double duration) {
-    if (!values || length <= 0 || duration <= 0.0) {
+    if (values.empty() || duration <= 0.0) {
+      publishEvents();
       return;
     }
-    std::lock_guard<std::mutex> lock(mtx);
     AutomationEvent event{AutomationEventType::ValueCurve, startTime,
-                          values[length - 1], 0.0f};
+                          values.back(), 0.0f};
     event.duration = duration;
-    event.curve.assign(values, values + length);
+    event.curve = adoptCurve(values);
     addEvent(event);
   }
 
   void cancelScheduledValues(double cancelTime) {
-    std::lock_guard<std::mutex> lock(mtx);
-    events.erase(std::remove_if(events.begin(), events.end(),
-                                [cancelTime](const AutomationEvent &e) {
-                                  return e.time >= cancelTime;
-                                }),
-                 events.end());
+    dropEventsFrom(cancelTime);
   }
 
   void cancelAndHoldAtTime(double cancelTime, double sampleRate) {
-    std::lock_guard<std::mutex> lock(mtx);
     const float held = valueAtTimeUnlocked(cancelTime, sampleRate);
-    events.erase(std::remove_if(events.begin(), events.end(),
-                                [cancelTime](const AutomationEvent &e) {
-                                  return e.time >= cancelTime;
-                                }),
-                 events.end());
+    dropEventsFrom(cancelTime);
     addEvent({AutomationEventType::SetValue, cancelTime, held, 0.0f});
   }
 
   // Process automation for a block of samples
-  // Returns the value at the end of the block
+  // Returns the value at the end of the block. When `constant` is given it
+  // is set to whether every sample of the block holds that same value.
   float processBlock(double startTime, double sampleRate, int numSamples,
-                     float *outputValues = nullptr) {
-    std::unique_lock<std::mutex> lock(mtx, std::try_to_lock);
-    if (!lock.owns_lock()) {
-      const float held = lastValue.load(std::memory_order_relaxed);
-      if (outputValues) {
-        std::fill(outputValues, outputValues + numSamples, held);
-      }
-      return held;
+                     float *outputValues = nullptr, bool *constant = nullptr) {
+    if (constant) {
+      *constant = true;
     }
-
     if (sampleRate <= 0.0 || numSamples <= 0) {
       return lastValue.load(std::memory_order_relaxed);
     }
 
     prunePastEvents(startTime);
 
+    // Split the block where events take over and fill each run with the
+    // kernel for the event that governs it.
     const float initialValue = lastValue.load(std::memory_order_relaxed);
     float val = initialValue;
-    int currentIdx = -1;
-    size_t nextIdx = 0;
-    while (nextIdx < events.size() && events[nextIdx].time <= startTime) {
-      currentIdx = static_cast<int>(nextIdx);
-      ++nextIdx;
-    }
-
-    for (int i = 0; i < numSamples; ++i) {
-      double t = startTime + (double)i / sampleRate;
-      while (nextIdx < events.size() && events[nextIdx].time <= t) {
-        currentIdx = static_cast<int>(nextIdx);
-        ++nextIdx;
+    size_t nextIdx = events.upperBound(startTime);
+    int currentIdx = static_cast<int>(nextIdx) - 1;
+
+    int begin = 0;
+    bool held = true;
+    float firstValue = initialValue;
+    while (begin < numSamples) {
+      const int end =
+          nextIdx < events.size()
+              ? firstSampleAtOrAfter(events[nextIdx].time, startTime,
+                                     sampleRate, numSamples)
+              : numSamples;
+      if (end > begin) {
+        bool segmentHeld = false;
+        val = fillSegment(initialValue, val, currentIdx, startTime, sampleRate,
+                          begin, end, outputValues, segmentHeld);
+        if (begin == 0) {
+          firstValue = val;
+        }
+        held = held && segmentHeld && val == firstValue;
+        begin = end;
+      }
+      if (begin < numSamples) {
+        const double t = startTime + static_cast<double>(begin) / sampleRate;
+        while (nextIdx < events.size() && events[nextIdx].time <= t) {
+          currentIdx = static_cast<int>(nextIdx);
+          ++nextIdx;
+        }
       }
-      val = getValueAtEventIndex(initialValue, val, currentIdx, t, sampleRate);
-      if (outputValues)
-        outputValues[i] = val;
+    }
+    if (constant) {
+      *constant = held;
     }
     lastValue.store(val, std::memory_order_relaxed);
     return val;
   }
 
+  // Web Audio automationRate: k-rate params are sampled once per render
+  // quantum instead of per sample.
+  void setKRate(bool enabled) {
+    kRate.store(enabled, std::memory_order_relaxed);
+  }
+
+  bool isKRate() const { return kRate.load(std::memory_order_relaxed); }
+
   void setLastValue(float v) {
-    std::lock_guard<std::mutex> lock(mtx);
     lastValue.store(v, std::memory_order_relaxed);
   }
 
+  // Most recent value published by processBlock or setLastValue.
+  float getLastValue() const {
+    return lastValue.load(std::memory_order_relaxed);
+  }
+
   bool holdsValueForBlock(float value, double startTime, double sampleRate,
                           int numSamples, float tolerance = 1.0e-7f) {
-    std::unique_lock<std::mutex> lock(mtx, std::try_to_lock);
-    if (!lock.owns_lock()) {
-      return false;
-    }
     if (sampleRate <= 0.0 || numSamples <= 0) {
       return std::abs(lastValue.load(std::memory_order_relaxed) - value) <=
              tolerance;
@@ -146,11 +315,8 @@ public:
     prunePastEvents(startTime);
     const double blockEnd = startTime + static_cast<double>(numSamples) /
                                             std::max(1.0, sampleRate);
-    for (const auto &event : events) {
-      if (event.time <= blockEnd) {
-        return false;
-      }
-      break;
+    if (!events.empty() && events[0].time <= blockEnd) {
+      return false;
     }
     return std::abs(lastValue.load(std::memory_order_relaxed) - value) <=
            tolerance;
@@ -197,23 +363,23 @@ private:
       case AutomationEventType::SetValue:
         value = event.value;
         break;
-      case AutomationEventType::ValueCurve:
-        if (!event.curve.empty() && event.duration > 0.0) {
+      case AutomationEventType::ValueCurve: {
+        const auto *curve = curveFor(event);
+        if (curve && event.duration > 0.0) {
           if (time >= event.time + event.duration) {
-            value = event.curve.back();
+            value = curve->back();
           } else {
             const double position =
-                ((time - event.time) / event.duration) *
-                (event.curve.size() - 1);
+                ((time - event.time) / event.duration) * (curve->size() - 1);
             const auto i0 = static_cast<size_t>(std::floor(position));
-            const auto i1 = std::min(i0 + 1, event.curve.size() - 1);
+            const auto i1 = std::min(i0 + 1, curve->size() - 1);
             const float frac =
                 static_cast<float>(position - std::floor(position));
-            value = event.curve[i0] +
-                    frac * (event.curve[i1] - event.curve[i0]);
+            value = (*curve)[i0] + frac * ((*curve)[i1] - (*curve)[i0]);
           }
         }
         break;
+      }
       case AutomationEventType::SetTarget:
         if (event.timeConstant > 0.0f) {
           value = event.value + (value - event.value) *
@@ -231,99 +397,169 @@ private:
     return value;
   }
 
-  float getValueAtEventIndex(float initialValue, float currentVal,
-                             int currentIdx, double time, double sampleRate) {
+  // First sample index (capped at `limit`) whose time reaches `time`. Uses
+  // the same time expression as the block loop, so segment boundaries land
+  // on the same samples as a per-sample scan would.
+  static int firstSampleAtOrAfter(double time, double startTime,
+                                  double sampleRate, int limit) {
+    const double estimate = std::ceil((time - startTime) * sampleRate);
+    if (!(estimate < static_cast<double>(limit))) {
+      return limit;
+    }
+    const auto at = [startTime, sampleRate](int i) {
+      return startTime + static_cast<double>(i) / sampleRate;
+    };
+    int i = static_cast<int>(std::max(0.0, estimate));
+    while (i > 0 && at(i - 1) >= time) {
+      --i;
+    }
+    while (i < limit && at(i) < time) {
+      ++i;
+    }
+    return i;
+  }
+
+  // Fills samples [begin, end) while `currentIdx` is the latest event that
+  // has started, and returns the value at the last sample. Ramps are filled
+  // as arithmetic or geometric progressions, setTarget as a geometric decay
+  // towards the target, and value curves by interpolating along a linear
+  // position. `held` reports whether the run was a single repeated value.
+  float fillSegment(float initialValue, float val, int currentIdx,
+                    double startTime, double sampleRate, int begin, int end,
+                    float *out, bool &held) const {
+    const int count = end - begin;
+    const double dt = 1.0 / sampleRate;
+    const double t0 = startTime + static_cast<double>(begin) / sampleRate;
+    const auto hold = [&](float value) {
+      held = true;
+      if (out) {
+        std::fill(out + begin, out + end, value);
+      }
+      return value;
+    };
+
     if (currentIdx < 0) {
-      return initialValue;
-    }
-
-    const auto &e = events[currentIdx];
-    float val = currentVal;
-
-    // 3. Check if the NEXT event is a ramp (Linear/Exponential)
-    // If so, we are currently in a ramping phase between currentIdx and
-    // currentIdx + 1
-    if ((size_t)currentIdx + 1 < events.size()) {
-      const auto &nextE = events[currentIdx + 1];
-      if (nextE.type == AutomationEventType::LinearRamp ||
-          nextE.type == AutomationEventType::ExponentialRamp) {
-
-        float startValue = events[currentIdx].value;
-        double startTime = events[currentIdx].time;
-        double endTime = nextE.time;
-        float duration = (float)(endTime - startTime);
-
-        if (duration > 0) {
-          float t = (float)((time - startTime) / duration);
-          t = std::max(0.0f, std::min(1.0f, t));
-
-          if (nextE.type == AutomationEventType::LinearRamp) {
-            return startValue + t * (nextE.value - startValue);
-          } else { // Exponential
-            if (startValue > 0 && nextE.value > 0) {
-              return startValue * std::pow(nextE.value / startValue, t);
+      return hold(initialValue);
+    }
+
+    const auto &e = events[static_cast<size_t>(currentIdx)];
+    if (static_cast<size_t>(currentIdx) + 1 < events.size()) {
+      const auto &next = events[static_cast<size_t>(currentIdx) + 1];
+      if (next.type == AutomationEventType::LinearRamp ||
+          next.type == AutomationEventType::ExponentialRamp) {
+        const double duration = next.time - e.time;
+        if (duration <= 0.0) {
+          return hold(next.value);
+        }
+        const double p0 = (t0 - e.time) / duration;
+        const double step = dt / duration;
+        if (next.type == AutomationEventType::LinearRamp) {
+          const float delta = next.value - e.value;
+          float v = val;
+          for (int k = 0; k < count; ++k) {
+            const double p = std::min(1.0, p0 + step * k);
+            v = e.value + static_cast<float>(p) * delta;
+            if (out) {
+              out[begin + k] = v;
             }
           }
+          return v;
+        }
+        if (e.value <= 0.0f || next.value <= 0.0f) {
+          return hold(next.value);
+        }
+        const double ratio = static_cast<double>(next.value) / e.value;
+        const double growth = std::pow(ratio, step);
+        double v = e.value * std::pow(ratio, p0);
+        float last = val;
+        for (int k = 0; k < count; ++k) {
+          last = static_cast<float>(v);
+          if (out) {
+            out[begin + k] = last;
+          }
+          v *= growth;
         }
-        return nextE.value;
+        return last;
       }
     }
 
-    // 4. No ramp ahead, process the current event's persistent behavior
     switch (e.type) {
-    case AutomationEventType::SetValue:
-    case AutomationEventType::LinearRamp:
-    case AutomationEventType::ExponentialRamp:
-      // These are discrete set-points, they just hold their value until next
-      // event
-      val = e.value;
-      break;
-
-    case AutomationEventType::ValueCurve:
-      if (!e.curve.empty() && e.duration > 0.0) {
-        if (time <= e.time) {
-          val = e.curve.front();
-        } else if (time >= e.time + e.duration) {
-          val = e.curve.back();
+    case AutomationEventType::ValueCurve: {
+      const auto *pooled = curveFor(e);
+      if (!pooled || e.duration <= 0.0) {
+        return hold(val);
+      }
+      const auto &curve = *pooled;
+      const size_t last = curve.size() - 1;
+      const double scale = static_cast<double>(last) / e.duration;
+      const double p0 = (t0 - e.time) * scale;
+      const double step = dt * scale;
+      float v = val;
+      for (int k = 0; k < count; ++k) {
+        const double position = p0 + step * k;
+        if (position >= static_cast<double>(last)) {
+          v = curve.back();
         } else {
-          const double position =
-              ((time - e.time) / e.duration) * (e.curve.size() - 1);
-          const auto i0 = static_cast<size_t>(std::floor(position));
-          const auto i1 = std::min(i0 + 1, e.curve.size() - 1);
+          const auto i0 = static_cast<size_t>(std::max(0.0, position));
           const float frac = static_cast<float>(position - std::floor(position));
-          val = e.curve[i0] + frac * (e.curve[i1] - e.curve[i0]);
+          v = curve[i0] + frac * (curve[i0 + 1] - curve[i0]);
+        }
+        if (out) {
+          out[begin + k] = v;
         }
       }
-      break;
+      return v;
+    }
 
-    case AutomationEventType::SetTarget:
-      if (time >= e.time && e.timeConstant > 0) {
-        // Recursive formula for smooth target approach (per sample)
-        float dt = 1.0f / (float)sampleRate;
-        val = e.value + (val - e.value) * std::exp(-dt / e.timeConstant);
+    case AutomationEventType::SetTarget: {
+      if (e.timeConstant <= 0.0f) {
+        return hold(val);
       }
-      break;
+      const float decay =
+          std::exp(-(1.0f / static_cast<float>(sampleRate)) / e.timeConstant);
+      float v = val;
+      for (int k = 0; k < count; ++k) {
+        v = e.value + (v - e.value) * decay;
+        if (out) {
+          out[begin + k] = v;
+        }
+      }
+      return v;
+    }
+
+    case AutomationEventType::SetValue:
+    case AutomationEventType::LinearRamp:
+    case AutomationEventType::ExponentialRamp:
+      // Discrete set-points hold their value until the next event.
+      return hold(e.value);
 
     default:
-      break;
+      return hold(val);
     }
+  }
 
-    return val;
+  // Each scheduling call counts as applied even if it adds nothing, so the
+  // control side's in-flight count stays exact.
+  void addEvent(const AutomationEvent &event) {
+    if (!events.insert(event)) {
+      releaseCurve(event);
+    }
+    publishEvents();
   }
 
-  void sortEvents() {
-    std::stable_sort(events.begin(), events.end(),
-                     [](const AutomationEvent &a, const AutomationEvent &b) {
-                       return a.time < b.time;
-                     });
+  void publishEvents() {
+    liveEvents.store(events.size(), std::memory_order_relaxed);
+    appliedEvents.store(appliedEvents.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_release);
   }
 
-  void addEvent(const AutomationEvent &event) {
-    events.push_back(event);
-    if (events.size() > 1 &&
-        events[events.size() - 2].time > events.back().time) {
-      sortEvents();
+  void dropEventsFrom(double cancelTime) {
+    const size_t keep = events.lowerBound(cancelTime);
+    while (events.size() > keep) {
+      releaseCurve(events[events.size() - 1]);
+      events.popBack();
     }
+    liveEvents.store(events.size(), std::memory_order_relaxed);
   }
 
   // Keep at most one event in the past as a baseline for future ramps.
@@ -331,20 +567,54 @@ private:
     if (events.size() < 3)
       return;
 
-    size_t keepFrom = 0;
-    while (keepFrom + 1 < events.size() && events[keepFrom + 1].time <= currentTime) {
-      ++keepFrom;
+    while (events.size() > 1 && events[1].time <= currentTime) {
+      releaseCurve(events[0]);
+      events.popFront();
+    }
+    liveEvents.store(events.size(), std::memory_order_relaxed);
+  }
+
+  const std::vector<float> *curveFor(const AutomationEvent &event) const {
+    if (event.curve < 0) {
+      return nullptr;
+    }
+    const auto &curve = curves[static_cast<size_t>(event.curve)];
+    return curve.empty() ? nullptr : &curve;
+  }
+
+  // reserveEvent() keeps a free handle for every event that can arrive; the
+  // curve is dropped rather than growing the pool here if that is ever off.
+  int32_t adoptCurve(std::vector<float> &values) {
+    if (freeCurves.empty()) {
+      return -1;
     }
+    const int32_t handle = freeCurves.back();
+    freeCurves.pop_back();
+    auto &slot = curves[static_cast<size_t>(handle)];
+    slot.swap(values);
+    values.clear();
+    return handle;
+  }
 
-    if (keepFrom > 0) {
-      events.erase(events.begin(),
-                   events.begin() + static_cast<std::ptrdiff_t>(keepFrom));
+  // Retired buffers stay in the pool; the next adoptCurve hands them back to
+  // the caller to free.
+  void releaseCurve(const AutomationEvent &event) {
+    if (event.curve >= 0) {
+      freeCurves.push_back(event.curve);
     }
   }
 
-  std::vector<AutomationEvent> events;
-  std::mutex mtx;
+  AutomationEventRing events;
+  std::vector<std::vector<float>> curves;
+  std::vector<int32_t> freeCurves;
   std::atomic<float> lastValue{0.0f};
+  std::atomic<bool> kRate{false};
+  // Published by the render thread for reserveEvent().
+  std::atomic<size_t> liveEvents{0};
+  std::atomic<uint64_t> appliedEvents{0};
+  // Control thread only.
+  uint64_t postedEvents = 0;
+  size_t reservedCapacity = AutomationEventRing::kInitialCapacity;
 };
 
 } // namespace wajuce
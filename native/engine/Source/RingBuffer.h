@@ -118,4 +118,57 @@ private:
   std::vector<std::unique_ptr<SPSCRingBuffer>> channels_buffers;
 };
 
+/**
+ * Fixed-capacity Single-Producer Single-Consumer queue of reusable slots.
+ * The consumer handles a slot in place and never destroys its contents; the
+ * producer overwrites a slot only after the consumer has released it, so any
+ * resources left behind in a slot are freed on the producer thread.
+ */
+template <typename T> class SPSCSlotQueue {
+public:
+  explicit SPSCSlotQueue(int capacity)
+      : capacity(std::max(2, capacity)),
+        slots(static_cast<size_t>(std::max(2, capacity))) {
+    readPos.store(0);
+    writePos.store(0);
+  }
+
+  // Producer side. Returns nullptr while the queue is full.
+  T *beginWrite() {
+    const int w = writePos.load(std::memory_order_relaxed);
+    const int next = (w + 1) % capacity;
+    if (next == readPos.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &slots[static_cast<size_t>(w)];
+  }
+
+  void commitWrite() {
+    const int w = writePos.load(std::memory_order_relaxed);
+    writePos.store((w + 1) % capacity, std::memory_order_release);
+  }
+
+  // Consumer side. Returns nullptr when there is nothing to read.
+  T *front() {
+    const int r = readPos.load(std::memory_order_relaxed);
+    if (r == writePos.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &slots[static_cast<size_t>(r)];
+  }
+
+  void pop() {
+    const int r = readPos.load(std::memory_order_relaxed);
+    readPos.store((r + 1) % capacity, std::memory_order_release);
+  }
+
+  int getCapacity() const { return capacity; }
+
+private:
+  int capacity;
+  std::vector<T> slots;
+  std::atomic<int> readPos;
+  std::atomic<int> writePos;
+};
+
 } // namespace wajuce
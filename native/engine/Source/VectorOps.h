@@ -0,0 +1,659 @@
+#pragma once
+/**
+ * VectorOps.h — Block arithmetic for audio buses.
+ * Every kernel has a portable version and SSE2, AVX2 and NEON versions where
+ * the target has them; the widest set the CPU supports is picked on first use.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WAJUCE_VECTOR_SSE2 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define WAJUCE_VECTOR_AVX2 1
+#define WAJUCE_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER)
+#define WAJUCE_VECTOR_AVX2 1
+#define WAJUCE_AVX2_TARGET
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define WAJUCE_VECTOR_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace wajuce {
+namespace vec {
+
+// One implementation of every kernel. Counts may be zero, and no pointer
+// needs any particular alignment.
+struct Kernels {
+  const char *name;
+  // dst[i] += src[i]
+  void (*add)(const float *src, float *dst, int n);
+  // dst[i] *= src[i]
+  void (*multiply)(const float *src, float *dst, int n);
+  // dst[i] += src[i] * gain
+  void (*multiplyAdd)(const float *src, float gain, float *dst, int n);
+  // dst[i] = src[i] * gain; dst may be src.
+  void (*scale)(const float *src, float gain, float *dst, int n);
+  // Same result as clampFloat per sample, NaN included.
+  void (*clamp)(float *data, float lo, float hi, int n);
+  // Largest magnitude; NaN samples are skipped.
+  float (*peak)(const float *src, int n);
+  float (*sumOfSquares)(const float *src, int n);
+  // planar holds channel c at planar + c * frames; interleaved holds frame i
+  // at interleaved + i * channels.
+  void (*interleave)(const float *planar, int frames, int channels,
+                     float *interleaved);
+  void (*deinterleave)(const float *interleaved, int frames, int channels,
+                       float *planar);
+};
+
+namespace scalar {
+
+inline void add(const float *src, float *dst, int n) {
+  for (int i = 0; i < n; ++i) {
+    dst[i] += src[i];
+  }
+}
+
+inline void multiply(const float *src, float *dst, int n) {
+  for (int i = 0; i < n; ++i) {
+    dst[i] *= src[i];
+  }
+}
+
+inline void multiplyAdd(const float *src, float gain, float *dst, int n) {
+  for (int i = 0; i < n; ++i) {
+    dst[i] += src[i] * gain;
+  }
+}
+
+inline void scale(const float *src, float gain, float *dst, int n) {
+  for (int i = 0; i < n; ++i) {
+    dst[i] = src[i] * gain;
+  }
+}
+
+inline void clamp(float *data, float lo, float hi, int n) {
+  for (int i = 0; i < n; ++i) {
+    const float upper = data[i] < hi ? data[i] : hi;
+    data[i] = upper > lo ? upper : lo;
+  }
+}
+
+inline float peak(const float *src, int n) {
+  float result = 0.0f;
+  for (int i = 0; i < n; ++i) {
+    const float magnitude = std::fabs(src[i]);
+    result = magnitude > result ? magnitude : result;
+  }
+  return result;
+}
+
+inline float sumOfSquares(const float *src, int n) {
+  float sum = 0.0f;
+  for (int i = 0; i < n; ++i) {
+    sum += src[i] * src[i];
+  }
+  return sum;
+}
+
+inline void interleave(const float *planar, int frames, int channels,
+                       float *interleaved) {
+  for (int ch = 0; ch < channels; ++ch) {
+    const float *src = planar + static_cast<size_t>(ch) * frames;
+    float *dst = interleaved + ch;
+    for (int i = 0; i < frames; ++i) {
+      dst[static_cast<size_t>(i) * channels] = src[i];
+    }
+  }
+}
+
+inline void deinterleave(const float *interleaved, int frames, int channels,
+                         float *planar) {
+  for (int ch = 0; ch < channels; ++ch) {
+    const float *src = interleaved + ch;
+    float *dst = planar + static_cast<size_t>(ch) * frames;
+    for (int i = 0; i < frames; ++i) {
+      dst[i] = src[static_cast<size_t>(i) * channels];
+    }
+  }
+}
+
+// Shared by the vector versions: interleaving is only vectorized for stereo,
+// and a single channel is a plain copy.
+inline bool copiesPlanar(const float *src, int frames, int channels,
+                         float *dst) {
+  if (channels != 1) {
+    return false;
+  }
+  if (frames > 0) {
+    std::memcpy(dst, src, static_cast<size_t>(frames) * sizeof(float));
+  }
+  return true;
+}
+
+inline const Kernels &kernels() {
+  static const Kernels set{"scalar", add, multiply, multiplyAdd, scale,
+                           clamp, peak, sumOfSquares, interleave,
+                           deinterleave};
+  return set;
+}
+
+} // namespace scalar
+
+#if defined(WAJUCE_VECTOR_SSE2)
+namespace sse2 {
+
+inline void add(const float *src, float *dst, int n) {
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(dst + i,
+                  _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+  }
+  scalar::add(src + i, dst + i, n - i);
+}
+
+inline void multiply(const float *src, float *dst, int n) {
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(dst + i,
+                  _mm_mul_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+  }
+  scalar::multiply(src + i, dst + i, n - i);
+}
+
+inline void multiplyAdd(const float *src, float gain, float *dst, int n) {
+  const __m128 g = _mm_set1_ps(gain);
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m128 product = _mm_mul_ps(_mm_loadu_ps(src + i), g);
+    _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), product));
+  }
+  scalar::multiplyAdd(src + i, gain, dst + i, n - i);
+}
+
+inline void scale(const float *src, float gain, float *dst, int n) {
+  const __m128 g = _mm_set1_ps(gain);
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+  }
+  scalar::scale(src + i, gain, dst + i, n - i);
+}
+
+inline void clamp(float *data, float lo, float hi, int n) {
+  const __m128 low = _mm_set1_ps(lo);
+  const __m128 high = _mm_set1_ps(hi);
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    // minps and maxps return their second operand for NaN, as clampFloat.
+    const __m128 upper = _mm_min_ps(_mm_loadu_ps(data + i), high);
+    _mm_storeu_ps(data + i, _mm_max_ps(upper, low));
+  }
+  scalar::clamp(data + i, lo, hi, n - i);
+}
+
+inline float peak(const float *src, int n) {
+  const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  __m128 lanes = _mm_setzero_ps();
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    lanes = _mm_max_ps(_mm_and_ps(_mm_loadu_ps(src + i), mask), lanes);
+  }
+  float partial[4];
+  _mm_storeu_ps(partial, lanes);
+  const float head = scalar::peak(partial, 4);
+  const float tail = scalar::peak(src + i, n - i);
+  return head > tail ? head : tail;
+}
+
+inline float sumOfSquares(const float *src, int n) {
+  __m128 lanes = _mm_setzero_ps();
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m128 x = _mm_loadu_ps(src + i);
+    lanes = _mm_add_ps(lanes, _mm_mul_ps(x, x));
+  }
+  float partial[4];
+  _mm_storeu_ps(partial, lanes);
+  return (partial[0] + partial[1]) + (partial[2] + partial[3]) +
+         scalar::sumOfSquares(src + i, n - i);
+}
+
+inline void interleave(const float *planar, int frames, int channels,
+                       float *interleaved) {
+  if (scalar::copiesPlanar(planar, frames, channels, interleaved)) {
+    return;
+  }
+  if (channels != 2) {
+    scalar::interleave(planar, frames, channels, interleaved);
+    return;
+  }
+  const float *left = planar;
+  const float *right = planar + frames;
+  int i = 0;
+  for (; i + 4 <= frames; i += 4) {
+    const __m128 l = _mm_loadu_ps(left + i);
+    const __m128 r = _mm_loadu_ps(right + i);
+    _mm_storeu_ps(interleaved + 2 * i, _mm_unpacklo_ps(l, r));
+    _mm_storeu_ps(interleaved + 2 * i + 4, _mm_unpackhi_ps(l, r));
+  }
+  for (; i < frames; ++i) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+}
+
+inline void deinterleave(const float *interleaved, int frames, int channels,
+                         float *planar) {
+  if (scalar::copiesPlanar(interleaved, frames, channels, planar)) {
+    return;
+  }
+  if (channels != 2) {
+    scalar::deinterleave(interleaved, frames, channels, planar);
+    return;
+  }
+  float *left = planar;
+  float *right = planar + frames;
+  int i = 0;
+  for (; i + 4 <= frames; i += 4) {
+    const __m128 a = _mm_loadu_ps(interleaved + 2 * i);
+    const __m128 b = _mm_loadu_ps(interleaved + 2 * i + 4);
+    _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  for (; i < frames; ++i) {
+    left[i] = interleaved[2 * i];
+    right[i] = interleaved[2 * i + 1];
+  }
+}
+
+inline const Kernels &kernels() {
+  static const Kernels set{"sse2", add, multiply, multiplyAdd, scale,
+                           clamp, peak, sumOfSquares, interleave,
+                           deinterleave};
+  return set;
+}
+
+} // namespace sse2
+#endif
+
+#if defined(WAJUCE_VECTOR_AVX2)
+// Built for AVX2 regardless of the compile flags; only reached after
+// supportsAvx2() has checked the CPU and the OS.
+namespace avx2 {
+
+WAJUCE_AVX2_TARGET inline void add(const float *src, float *dst, int n) {
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i),
+                                            _mm256_loadu_ps(src + i)));
+  }
+  sse2::add(src + i, dst + i, n - i);
+}
+
+WAJUCE_AVX2_TARGET inline void multiply(const float *src, float *dst, int n) {
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(dst + i),
+                                            _mm256_loadu_ps(src + i)));
+  }
+  sse2::multiply(src + i, dst + i, n - i);
+}
+
+WAJUCE_AVX2_TARGET inline void multiplyAdd(const float *src, float gain,
+                                           float *dst, int n) {
+  const __m256 g = _mm256_set1_ps(gain);
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256 product = _mm256_mul_ps(_mm256_loadu_ps(src + i), g);
+    _mm256_storeu_ps(dst + i,
+                     _mm256_add_ps(_mm256_loadu_ps(dst + i), product));
+  }
+  sse2::multiplyAdd(src + i, gain, dst + i, n - i);
+}
+
+WAJUCE_AVX2_TARGET inline void scale(const float *src, float gain, float *dst,
+                                     int n) {
+  const __m256 g = _mm256_set1_ps(gain);
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), g));
+  }
+  sse2::scale(src + i, gain, dst + i, n - i);
+}
+
+WAJUCE_AVX2_TARGET inline void clamp(float *data, float lo, float hi, int n) {
+  const __m256 low = _mm256_set1_ps(lo);
+  const __m256 high = _mm256_set1_ps(hi);
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256 upper = _mm256_min_ps(_mm256_loadu_ps(data + i), high);
+    _mm256_storeu_ps(data + i, _mm256_max_ps(upper, low));
+  }
+  sse2::clamp(data + i, lo, hi, n - i);
+}
+
+WAJUCE_AVX2_TARGET inline float peak(const float *src, int n) {
+  const __m256 mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  __m256 lanes = _mm256_setzero_ps();
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    lanes = _mm256_max_ps(_mm256_and_ps(_mm256_loadu_ps(src + i), mask), lanes);
+  }
+  float partial[8];
+  _mm256_storeu_ps(partial, lanes);
+  const float head = scalar::peak(partial, 8);
+  const float tail = sse2::peak(src + i, n - i);
+  return head > tail ? head : tail;
+}
+
+WAJUCE_AVX2_TARGET inline float sumOfSquares(const float *src, int n) {
+  __m256 lanes = _mm256_setzero_ps();
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256 x = _mm256_loadu_ps(src + i);
+    lanes = _mm256_add_ps(lanes, _mm256_mul_ps(x, x));
+  }
+  float partial[8];
+  _mm256_storeu_ps(partial, lanes);
+  return ((partial[0] + partial[1]) + (partial[2] + partial[3])) +
+         ((partial[4] + partial[5]) + (partial[6] + partial[7])) +
+         sse2::sumOfSquares(src + i, n - i);
+}
+
+WAJUCE_AVX2_TARGET inline void interleave(const float *planar, int frames,
+                                          int channels, float *interleaved) {
+  if (channels != 2) {
+    sse2::interleave(planar, frames, channels, interleaved);
+    return;
+  }
+  const float *left = planar;
+  const float *right = planar + frames;
+  int i = 0;
+  for (; i + 8 <= frames; i += 8) {
+    const __m256 l = _mm256_loadu_ps(left + i);
+    const __m256 r = _mm256_loadu_ps(right + i);
+    // The unpacks work per 128-bit half; the permutes put the halves in order.
+    const __m256 low = _mm256_unpacklo_ps(l, r);
+    const __m256 high = _mm256_unpackhi_ps(l, r);
+    _mm256_storeu_ps(interleaved + 2 * i,
+                     _mm256_permute2f128_ps(low, high, 0x20));
+    _mm256_storeu_ps(interleaved + 2 * i + 8,
+                     _mm256_permute2f128_ps(low, high, 0x31));
+  }
+  for (; i < frames; ++i) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+}
+
+WAJUCE_AVX2_TARGET inline void deinterleave(const float *interleaved,
+                                            int frames, int channels,
+                                            float *planar) {
+  if (channels != 2) {
+    sse2::deinterleave(interleaved, frames, channels, planar);
+    return;
+  }
+  float *left = planar;
+  float *right = planar + frames;
+  int i = 0;
+  for (; i + 8 <= frames; i += 8) {
+    const __m256 a = _mm256_loadu_ps(interleaved + 2 * i);
+    const __m256 b = _mm256_loadu_ps(interleaved + 2 * i + 8);
+    const __m256 first = _mm256_permute2f128_ps(a, b, 0x20);
+    const __m256 second = _mm256_permute2f128_ps(a, b, 0x31);
+    _mm256_storeu_ps(left + i,
+                     _mm256_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm256_storeu_ps(right + i,
+                     _mm256_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  for (; i < frames; ++i) {
+    left[i] = interleaved[2 * i];
+    right[i] = interleaved[2 * i + 1];
+  }
+}
+
+inline const Kernels &kernels() {
+  static const Kernels set{"avx2", add, multiply, multiplyAdd, scale,
+                           clamp, peak, sumOfSquares, interleave,
+                           deinterleave};
+  return set;
+}
+
+inline bool supportsAvx2() {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  __cpuid(info, 1);
+  const bool osSavesYmm = (info[2] & (1 << 27)) != 0 &&
+                          (info[2] & (1 << 28)) != 0 &&
+                          (_xgetbv(0) & 6) == 6;
+  __cpuidex(info, 7, 0);
+  return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+} // namespace avx2
+#endif
+
+#if defined(WAJUCE_VECTOR_NEON)
+namespace neon {
+
+inline void add(const float *src, float *dst, int n) {
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+  }
+  scalar::add(src + i, dst + i, n - i);
+}
+
+inline void multiply(const float *src, float *dst, int n) {
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vst1q_f32(dst + i, vmulq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+  }
+  scalar::multiply(src + i, dst + i, n - i);
+}
+
+inline void multiplyAdd(const float *src, float gain, float *dst, int n) {
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const float32x4_t product = vmulq_n_f32(vld1q_f32(src + i), gain);
+    vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), product));
+  }
+  scalar::multiplyAdd(src + i, gain, dst + i, n - i);
+}
+
+inline void scale(const float *src, float gain, float *dst, int n) {
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(src + i), gain));
+  }
+  scalar::scale(src + i, gain, dst + i, n - i);
+}
+
+inline void clamp(float *data, float lo, float hi, int n) {
+  const float32x4_t low = vdupq_n_f32(lo);
+  const float32x4_t high = vdupq_n_f32(hi);
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    // Selects rather than vminq/vmaxq, which would keep NaN.
+    const float32x4_t x = vld1q_f32(data + i);
+    const float32x4_t upper = vbslq_f32(vcltq_f32(x, high), x, high);
+    vst1q_f32(data + i, vbslq_f32(vcgtq_f32(upper, low), upper, low));
+  }
+  scalar::clamp(data + i, lo, hi, n - i);
+}
+
+inline float peak(const float *src, int n) {
+  float32x4_t lanes = vdupq_n_f32(0.0f);
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const float32x4_t magnitude = vabsq_f32(vld1q_f32(src + i));
+    lanes = vbslq_f32(vcgtq_f32(magnitude, lanes), magnitude, lanes);
+  }
+  float partial[4];
+  vst1q_f32(partial, lanes);
+  const float head = scalar::peak(partial, 4);
+  const float tail = scalar::peak(src + i, n - i);
+  return head > tail ? head : tail;
+}
+
+inline float sumOfSquares(const float *src, int n) {
+  float32x4_t lanes = vdupq_n_f32(0.0f);
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const float32x4_t x = vld1q_f32(src + i);
+    lanes = vaddq_f32(lanes, vmulq_f32(x, x));
+  }
+  float partial[4];
+  vst1q_f32(partial, lanes);
+  return (partial[0] + partial[1]) + (partial[2] + partial[3]) +
+         scalar::sumOfSquares(src + i, n - i);
+}
+
+inline void interleave(const float *planar, int frames, int channels,
+                       float *interleaved) {
+  if (scalar::copiesPlanar(planar, frames, channels, interleaved)) {
+    return;
+  }
+  if (channels != 2) {
+    scalar::interleave(planar, frames, channels, interleaved);
+    return;
+  }
+  const float *left = planar;
+  const float *right = planar + frames;
+  int i = 0;
+  for (; i + 4 <= frames; i += 4) {
+    float32x4x2_t pair;
+    pair.val[0] = vld1q_f32(left + i);
+    pair.val[1] = vld1q_f32(right + i);
+    vst2q_f32(interleaved + 2 * i, pair);
+  }
+  for (; i < frames; ++i) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+}
+
+inline void deinterleave(const float *interleaved, int frames, int channels,
+                         float *planar) {
+  if (scalar::copiesPlanar(interleaved, frames, channels, planar)) {
+    return;
+  }
+  if (channels != 2) {
+    scalar::deinterleave(interleaved, frames, channels, planar);
+    return;
+  }
+  float *left = planar;
+  float *right = planar + frames;
+  int i = 0;
+  for (; i + 4 <= frames; i += 4) {
+    const float32x4x2_t pair = vld2q_f32(interleaved + 2 * i);
+    vst1q_f32(left + i, pair.val[0]);
+    vst1q_f32(right + i, pair.val[1]);
+  }
+  for (; i < frames; ++i) {
+    left[i] = interleaved[2 * i];
+    right[i] = interleaved[2 * i + 1];
+  }
+}
+
+inline const Kernels &kernels() {
+  static const Kernels set{"neon", add, multiply, multiplyAdd, scale,
+                           clamp, peak, sumOfSquares, interleave,
+                           deinterleave};
+  return set;
+}
+
+} // namespace neon
+#endif
+
+// Every set this build and CPU can run, narrowest first; the scalar set is
+// always present.
+inline const std::vector<const Kernels *> &supportedKernels() {
+  static const std::vector<const Kernels *> sets = [] {
+    std::vector<const Kernels *> found{&scalar::kernels()};
+#if defined(WAJUCE_VECTOR_SSE2)
+    found.push_back(&sse2::kernels());
+#endif
+#if defined(WAJUCE_VECTOR_AVX2)
+    if (avx2::supportsAvx2()) {
+      found.push_back(&avx2::kernels());
+    }
+#endif
+#if defined(WAJUCE_VECTOR_NEON)
+    found.push_back(&neon::kernels());
+#endif
+    return found;
+  }();
+  return sets;
+}
+
+inline const Kernels &activeKernels() {
+  static const Kernels &active = *supportedKernels().back();
+  return active;
+}
+
+inline void add(const float *src, float *dst, int n) {
+  activeKernels().add(src, dst, n);
+}
+
+inline void multiply(const float *src, float *dst, int n) {
+  activeKernels().multiply(src, dst, n);
+}
+
+inline void multiplyAdd(const float *src, float gain, float *dst, int n) {
+  activeKernels().multiplyAdd(src, gain, dst, n);
+}
+
+inline void scale(const float *src, float gain, float *dst, int n) {
+  activeKernels().scale(src, gain, dst, n);
+}
+
+inline void clamp(float *data, float lo, float hi, int n) {
+  activeKernels().clamp(data, lo, hi, n);
+}
+
+inline float peak(const float *src, int n) {
+  return activeKernels().peak(src, n);
+}
+
+inline float rms(const float *src, int n) {
+  return n > 0 ? std::sqrt(activeKernels().sumOfSquares(src, n) /
+                           static_cast<float>(n))
+               : 0.0f;
+}
+
+inline void interleave(const float *planar, int frames, int channels,
+                       float *interleaved) {
+  activeKernels().interleave(planar, frames, channels, interleaved);
+}
+
+inline void deinterleave(const float *interleaved, int frames, int channels,
+                         float *planar) {
+  activeKernels().deinterleave(interleaved, frames, channels, planar);
+}
+
+} // namespace vec
+} // namespace wajuce
@@ -1,4 +1,5 @@
 #include "WAIPlugEngine.h"
+#include "VectorOps.h"
 
 #include "../../../src/wajuce.h"
 
@@ -21,6 +22,7 @@
 #endif
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <cstdio>
@@ -29,6 +31,7 @@
 #include <limits>
 #include <numeric>
 #include <queue>
+#include <thread>
 #include <unordered_set>
 
 #if defined(WAJUCE_USE_APPLE_AUDIOUNIT) && WAJUCE_USE_APPLE_AUDIOUNIT &&        \
@@ -41,6 +44,65 @@ namespace {
 constexpr double kPi = 3.14159265358979323846264338327950288;
 constexpr float kSilentFloor = 1.0e-12f;
 constexpr float kNeutralDecaySeconds = 1.0e12f;
+// Filter state below this (about -140 dB) counts as a finished tail.
+constexpr float kTailFloor = 1.0e-7f;
+// Render quantum from the Web Audio spec. Engine::render splits every caller
+// block into quanta of this size, so node buses never grow past it.
+constexpr int kRenderQuantumFrames = 128;
+constexpr int kMaxRenderWorkers = 15;
+// While biquad params are automated the filter design is evaluated every
+// this many samples and the coefficients are interpolated in between.
+constexpr int kBiquadControlInterval = 16;
+// A convolver swapping responses fades the old one out over this long.
+constexpr double kConvolverCrossfadeSeconds = 0.05;
+constexpr double kCompressorMaxLookaheadSeconds = 0.1;
+// Worklet params are named on demand into a table of this many slots.
+constexpr size_t kMaxWorkletParams = 32;
+
+// Param slots, in the order each node kind registers them. Kernels address
+// params by slot; names are only resolved at the API boundary.
+enum ListenerParam : int32_t {
+  kListenerPositionX,
+  kListenerPositionY,
+  kListenerPositionZ,
+  kListenerForwardX,
+  kListenerForwardY,
+  kListenerForwardZ,
+  kListenerUpX,
+  kListenerUpY,
+  kListenerUpZ,
+};
+enum GainParam : int32_t { kGainGain };
+enum OscillatorParam : int32_t { kOscFrequency, kOscDetune };
+enum BiquadParam : int32_t {
+  kBiquadFrequency,
+  kBiquadDetune,
+  kBiquadQ,
+  kBiquadGain,
+};
+enum CompressorParam : int32_t {
+  kCompressorThreshold,
+  kCompressorKnee,
+  kCompressorRatio,
+  kCompressorAttack,
+  kCompressorRelease,
+};
+enum DelayParam : int32_t { kDelayTime, kDelayFeedback };
+enum BufferSourceParam : int32_t {
+  kSourcePlaybackRate,
+  kSourceDetune,
+  kSourceDecay,
+};
+enum StereoPannerParam : int32_t { kStereoPannerPan };
+enum PannerParam : int32_t {
+  kPannerPositionX,
+  kPannerPositionY,
+  kPannerPositionZ,
+  kPannerOrientationX,
+  kPannerOrientationY,
+  kPannerOrientationZ,
+};
+enum ConstantSourceParam : int32_t { kConstantOffset };
 
 #define WA_LOG(fmt, ...) fprintf(stderr, "[wajuce] " fmt "\n", ##__VA_ARGS__)
 
@@ -48,7 +110,68 @@ float clampFloat(float v, float lo, float hi) {
   return std::max(lo, std::min(hi, v));
 }
 
-float decibelsToGain(float db) { return std::pow(10.0f, db / 20.0f); }
+// log2 of a positive normal float: the exponent is read from the bits and the
+// mantissa, folded into [sqrt(1/2), sqrt(2)), goes through a short atanh
+// series. Relative error is about 1e-7.
+float fastLog2(float x) {
+  uint32_t bits = 0;
+  std::memcpy(&bits, &x, sizeof bits);
+  int exponent = static_cast<int>((bits >> 23) & 0xff) - 127;
+  bits = (bits & 0x007fffffu) | 0x3f800000u;
+  float mantissa = 0.0f;
+  std::memcpy(&mantissa, &bits, sizeof mantissa);
+  if (mantissa > 1.41421356f) {
+    mantissa *= 0.5f;
+    ++exponent;
+  }
+  const float s = (mantissa - 1.0f) / (mantissa + 1.0f);
+  const float s2 = s * s;
+  const float ln =
+      s * (2.0f + s2 * (2.0f / 3.0f + s2 * (2.0f / 5.0f + s2 * (2.0f / 7.0f))));
+  return static_cast<float>(exponent) + ln * 1.44269504f;
+}
+
+// 2^x, from an integer power built in the exponent bits and a Taylor
+// polynomial over the remaining [-0.5, 0.5].
+float fastExp2(float x) {
+  x = clampFloat(x, -126.0f, 126.0f);
+  const float whole = std::floor(x + 0.5f);
+  const float t = (x - whole) * 0.693147181f;
+  const float fraction =
+      1.0f +
+      t * (1.0f +
+           t * (1.0f / 2.0f +
+                t * (1.0f / 6.0f +
+                     t * (1.0f / 24.0f + t * (1.0f / 120.0f + t / 720.0f)))));
+  const uint32_t bits = static_cast<uint32_t>(static_cast<int>(whole) + 127)
+                        << 23;
+  float scale = 0.0f;
+  std::memcpy(&scale, &bits, sizeof scale);
+  return fraction * scale;
+}
+
+float fastGainToDecibels(float gain) { return 6.02059991f * fastLog2(gain); }
+
+float fastDecibelsToGain(float db) { return fastExp2(db * 0.166096405f); }
+
+float shapeWithCurve(const std::vector<float> &curve, float sample) {
+  if (curve.empty()) {
+    return sample;
+  }
+  const int len = static_cast<int>(curve.size());
+  const float x = clampFloat(sample, -1.0f, 1.0f);
+  const float idx = (x + 1.0f) * 0.5f * (len - 1);
+  const int i0 = std::max(0, std::min(len - 1, static_cast<int>(idx)));
+  const int i1 = std::min(len - 1, i0 + 1);
+  const float frac = idx - i0;
+  return curve[static_cast<size_t>(i0)] +
+         frac * (curve[static_cast<size_t>(i1)] - curve[static_cast<size_t>(i0)]);
+}
+
+template <typename Edge, typename Pred>
+void eraseEdgesIf(std::vector<Edge> &edges, Pred pred) {
+  edges.erase(std::remove_if(edges.begin(), edges.end(), pred), edges.end());
+}
 
 } // namespace
 
@@ -57,11 +180,41 @@ namespace wajuce {
 std::unordered_map<int32_t, std::shared_ptr<Engine>> g_engines;
 std::mutex g_engineMtx;
 int32_t g_nextCtxId = 1;
+// Engines by the route stamped into their node handles. Entries are read
+// and written with the shared_ptr atomic functions, so resolving a node
+// takes neither g_engineMtx nor any engine's graph lock.
+std::array<std::shared_ptr<Engine>, Engine::kMaxNodeRoutes> g_engineRoutes;
+// Slot generations left by the last engine on each route.
+std::array<std::vector<uint32_t>, Engine::kMaxNodeRoutes> g_routeGenerations;
+uint32_t g_nextRoute = 1;
+
+// Picks a free route, starting after the last one handed out so a
+// destroyed context's handles are not reused straight away. Returns 0 when
+// every route is taken. Called with g_engineMtx held.
+static uint32_t allocateRouteLocked() {
+  for (uint32_t i = 0; i + 1 < Engine::kMaxNodeRoutes; ++i) {
+    const uint32_t route =
+        1u + (g_nextRoute - 1u + i) % (Engine::kMaxNodeRoutes - 1u);
+    if (!std::atomic_load(&g_engineRoutes[route])) {
+      g_nextRoute = 1u + route % (Engine::kMaxNodeRoutes - 1u);
+      return route;
+    }
+  }
+  return 0;
+}
 
 std::shared_ptr<Engine> findEngineForNode(int32_t nodeId) {
+  if (nodeId < 0) {
+    return {};
+  }
+  if (const uint32_t route = Engine::handleRoute(nodeId)) {
+    return std::atomic_load(&g_engineRoutes[route]);
+  }
+  // Contexts created after every route was taken share route 0.
   std::lock_guard<std::mutex> lock(g_engineMtx);
   for (auto &[_, engine] : g_engines) {
-    if (engine && engine->containsNode(nodeId)) {
+    if (engine && Engine::handleRoute(engine->getDestinationId()) == 0 &&
+        engine->containsNode(nodeId)) {
       return engine;
     }
   }
@@ -77,7 +230,7 @@ static std::shared_ptr<Engine> getEngine(int32_t ctxId) {
 void Engine::AudioBus::resize(int nextChannels, int nextFrames) {
   channels = std::max(1, nextChannels);
   frames = std::max(0, nextFrames);
-  samples.assign(static_cast<size_t>(channels * frames), 0.0f);
+  samples.resize(static_cast<size_t>(channels * frames));
 }
 
 void Engine::AudioBus::clear() {
@@ -98,44 +251,66 @@ const float *Engine::AudioBus::channel(int ch) const {
   return samples.data() + static_cast<size_t>(ch * frames);
 }
 
-static void setDefaultParam(Engine::Node &node, const char *name, float value) {
-  node.paramValues[name] = value;
-  auto timeline = std::make_unique<ParamTimeline>();
-  timeline->setLastValue(value);
-  node.timelines[name] = std::move(timeline);
-}
-
-Engine::Engine(double sr, int bs, int inCh, int outCh)
-    : sampleRate(sr > 0.0 ? sr : 44100.0), bufferSize(std::max(32, bs)),
-      inputChannels(std::max(0, inCh)), outputChannels(std::max(1, outCh)),
-      renderChannels(std::max(1, outCh)) {
-  Node destination;
-  destination.id = 0;
-  destination.kind = NodeKind::Destination;
-  destination.inputCount = 1;
-  destination.outputCount = 0;
-  destination.current.resize(renderChannels, bufferSize.load());
-  destination.previous.resize(renderChannels, bufferSize.load());
-  nodes.emplace(0, std::move(destination));
-
-  Node listener;
-  listener.id = nextNodeId++;
-  listener.kind = NodeKind::Listener;
-  listener.inputCount = 0;
-  listener.outputCount = 0;
-  setDefaultParam(listener, "positionX", 0.0f);
-  setDefaultParam(listener, "positionY", 0.0f);
-  setDefaultParam(listener, "positionZ", 0.0f);
-  setDefaultParam(listener, "forwardX", 0.0f);
-  setDefaultParam(listener, "forwardY", 0.0f);
-  setDefaultParam(listener, "forwardZ", -1.0f);
-  setDefaultParam(listener, "upX", 0.0f);
-  setDefaultParam(listener, "upY", 1.0f);
-  setDefaultParam(listener, "upZ", 0.0f);
-  listener.current.resize(renderChannels, bufferSize.load());
-  listener.previous.resize(renderChannels, bufferSize.load());
-  listenerNodeId = listener.id;
-  nodes.emplace(listenerNodeId, std::move(listener));
+// Params registered k-rate are the ones the spec fixes at k-rate (compressor
+// params, buffer source playbackRate and detune), so they also lock the rate.
+static void setDefaultParam(Engine::Node &node, int32_t slot, const char *name,
+                            float value, bool kRate = false) {
+  if (node.params.size() <= static_cast<size_t>(slot)) {
+    node.params.resize(static_cast<size_t>(slot) + 1);
+  }
+  auto &param = node.params[static_cast<size_t>(slot)];
+  param.name = name;
+  param.timeline = std::make_unique<ParamTimeline>();
+  param.timeline->setLastValue(value);
+  param.timeline->setKRate(kRate);
+  param.fixedRate = kRate;
+}
+
+Engine::Engine(double sr, int bs, int inCh, int outCh, uint32_t route,
+               const std::vector<uint32_t> &generations)
+    : nodeRoute(route & (kMaxNodeRoutes - 1u)),
+      renderChannels(std::max(1, outCh)),
+      sampleRate(sr > 0.0 ? sr : 44100.0), bufferSize(std::max(32, bs)),
+      inputChannels(std::max(0, inCh)), outputChannels(std::max(1, outCh)) {
+  nodeSlots.resize(std::max<size_t>(1, generations.size()));
+  for (size_t slot = 0; slot < generations.size(); ++slot) {
+    nodeSlots[slot].generation = generations[slot];
+    if (slot > 0) {
+      freeNodeSlots.push_back(static_cast<uint32_t>(slot));
+    }
+  }
+  auto destination = std::make_unique<Node>();
+  destinationNodeId = composeHandle(nodeSlots[0].generation, 0);
+  destination->id = destinationNodeId;
+  destination->kind = NodeKind::Destination;
+  destination->inputCount = 1;
+  destination->outputCount = 0;
+  preparedChannelCount.store(renderChannels, std::memory_order_relaxed);
+  destination->current.resize(renderChannels, kRenderQuantumFrames);
+  destination->previous.resize(renderChannels, kRenderQuantumFrames);
+  prepareRenderScratch(*destination, renderChannels, kRenderQuantumFrames);
+  destinationNode = destination.get();
+  nodeSlots[0].node = std::move(destination);
+  liveNodeCount = 1;
+
+  auto listener = std::make_unique<Node>();
+  listener->kind = NodeKind::Listener;
+  listener->inputCount = 0;
+  listener->outputCount = 0;
+  setDefaultParam(*listener, kListenerPositionX, "positionX", 0.0f);
+  setDefaultParam(*listener, kListenerPositionY, "positionY", 0.0f);
+  setDefaultParam(*listener, kListenerPositionZ, "positionZ", 0.0f);
+  setDefaultParam(*listener, kListenerForwardX, "forwardX", 0.0f);
+  setDefaultParam(*listener, kListenerForwardY, "forwardY", 0.0f);
+  setDefaultParam(*listener, kListenerForwardZ, "forwardZ", -1.0f);
+  setDefaultParam(*listener, kListenerUpX, "upX", 0.0f);
+  setDefaultParam(*listener, kListenerUpY, "upY", 1.0f);
+  setDefaultParam(*listener, kListenerUpZ, "upZ", 0.0f);
+  listenerNode = listener.get();
+  listenerNodeId = addNode(std::move(listener));
+
+  std::lock_guard<std::recursive_mutex> lock(graphMtx);
+  publishRenderPlanUnlocked();
 }
 
 Engine::~Engine() { close(); }
@@ -167,6 +342,8 @@ void Engine::suspend() {
 
 void Engine::close() {
   state.store(2, std::memory_order_release);
+  // Before graphMtx: a running job may be waiting for it.
+  stopPreparationWorker();
 #if defined(WAJUCE_USE_RTAUDIO) && WAJUCE_USE_RTAUDIO
   closeRealtimeStream();
 #endif
@@ -174,13 +351,45 @@ void Engine::close() {
   closeAppleAudioUnit();
 #endif
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
+  stopRenderWorkersUnlocked();
+  if (liveNodeCount == 0) {
+    return;
+  }
   connections.clear();
-  nodes.clear();
+  paramConnections.clear();
+  // Hand the render thread an empty plan and wait until it lets go of the old
+  // one before the nodes are freed.
+  auto emptyPlan = std::make_shared<RenderPlan>();
+  postCommandUnlocked([this, emptyPlan] { installRenderPlan(*emptyPlan); });
+  waitForCommandsUnlocked();
+  retiredNodes.clear();
+  destinationNode = nullptr;
+  listenerNode = nullptr;
+  for (uint32_t slot = 0; slot < nodeSlots.size(); ++slot) {
+    if (nodeSlots[slot].node) {
+      nodeSlots[slot].node.reset();
+      releaseNodeSlotUnlocked(slot);
+    }
+  }
+  liveNodeCount = 0;
+}
+
+std::vector<uint32_t> Engine::retireNodeGenerations() {
+  std::lock_guard<std::recursive_mutex> lock(graphMtx);
+  nodeHandlesRetired = true;
+  std::vector<uint32_t> generations;
+  generations.reserve(nodeSlots.size());
+  for (const auto &entry : nodeSlots) {
+    generations.push_back(entry.node
+                              ? (entry.generation + 1u) & kNodeGenerationMask
+                              : entry.generation);
+  }
+  return generations;
 }
 
 int32_t Engine::getLiveNodeCount() {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  return static_cast<int32_t>(nodes.size());
+  return liveNodeCount;
 }
 
 int32_t Engine::getMachineVoiceGroupCount() {
@@ -202,99 +411,301 @@ bool Engine::setPreferredBitDepth(int bitDepth) {
   return true;
 }
 
-int32_t Engine::addNode(Node node) {
+bool Engine::setRenderThreadCount(int workerThreads) {
+  if (workerThreads < 0 || state.load(std::memory_order_relaxed) == 2) {
+    return false;
+  }
+  const int count = std::min(workerThreads, kMaxRenderWorkers);
+  std::lock_guard<std::recursive_mutex> lock(graphMtx);
+  if (count == static_cast<int>(renderWorkers.size())) {
+    return true;
+  }
+  stopRenderWorkersUnlocked();
+  renderWorkersExit.store(false, std::memory_order_release);
+  for (int i = 0; i < count; ++i) {
+    renderWorkers.emplace_back([this] { renderWorkerMain(); });
+  }
+  renderWorkerCount.store(count, std::memory_order_release);
+  return true;
+}
+
+void Engine::stopRenderWorkersUnlocked() {
+  renderWorkerCount.store(0, std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> wakeLock(renderWorkerMtx);
+    renderWorkersExit.store(true, std::memory_order_release);
+  }
+  renderWorkerWake.notify_all();
+  for (auto &worker : renderWorkers) {
+    worker.join();
+  }
+  renderWorkers.clear();
+}
+
+// Jobs queue behind the worker while a live stream is running. Otherwise the
+// caller runs them itself, so offline renders see their results in order.
+void Engine::runPreparation(std::function<void()> job) {
+  if (state.load(std::memory_order_acquire) != 1) {
+    job();
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(preparationMtx);
+    if (preparationExit) {
+      return;
+    }
+    preparationJobs.push_back(std::move(job));
+    if (!preparationWorker.joinable()) {
+      preparationWorker = std::thread([this] { preparationWorkerMain(); });
+    }
+  }
+  preparationWake.notify_one();
+}
+
+void Engine::preparationWorkerMain() {
+  std::unique_lock<std::mutex> lock(preparationMtx);
+  while (true) {
+    preparationWake.wait(lock, [this] {
+      return preparationExit || !preparationJobs.empty();
+    });
+    if (preparationExit) {
+      return;
+    }
+    auto job = std::move(preparationJobs.front());
+    preparationJobs.pop_front();
+    lock.unlock();
+    job();
+    lock.lock();
+  }
+}
+
+void Engine::stopPreparationWorker() {
+  {
+    std::lock_guard<std::mutex> lock(preparationMtx);
+    preparationExit = true;
+    preparationJobs.clear();
+  }
+  preparationWake.notify_all();
+  if (preparationWorker.joinable()) {
+    preparationWorker.join();
+  }
+}
+
+int32_t Engine::addNode(std::unique_ptr<Node> node) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  const int32_t id = nextNodeId++;
-  node.id = id;
-  node.current.resize(renderChannels, bufferSize.load());
-  node.previous.resize(renderChannels, bufferSize.load());
-  nodes.emplace(id, std::move(node));
+  if (nodeHandlesRetired) {
+    return -1;
+  }
+  uint32_t slot;
+  if (freeNodeSlots.size() > kMinFreeNodeSlots ||
+      (!freeNodeSlots.empty() && nodeSlots.size() > kNodeSlotMask)) {
+    slot = freeNodeSlots.front();
+    freeNodeSlots.pop_front();
+  } else {
+    slot = static_cast<uint32_t>(nodeSlots.size());
+    if (slot > kNodeSlotMask) {
+      return -1;
+    }
+    nodeSlots.emplace_back();
+  }
+  auto &entry = nodeSlots[slot];
+  const int32_t id = composeHandle(entry.generation, slot);
+  const int channels = outputChannels.load(std::memory_order_relaxed);
+  node->id = id;
+  node->current.resize(channels, kRenderQuantumFrames);
+  node->previous.resize(channels, kRenderQuantumFrames);
+  prepareRenderScratch(*node, channels, kRenderQuantumFrames);
+  entry.node = std::move(node);
+  ++liveNodeCount;
   return id;
 }
 
+std::unique_ptr<Engine::Node> Engine::takeNodeUnlocked(int32_t nodeId) {
+  if (!findNodeUnlocked(nodeId)) {
+    return nullptr;
+  }
+  const uint32_t slot = static_cast<uint32_t>(nodeId) & kNodeSlotMask;
+  auto node = std::move(nodeSlots[slot].node);
+  releaseNodeSlotUnlocked(slot);
+  --liveNodeCount;
+  return node;
+}
+
+void Engine::releaseNodeSlotUnlocked(uint32_t slot) {
+  auto &entry = nodeSlots[slot];
+  entry.generation = (entry.generation + 1u) & kNodeGenerationMask;
+  freeNodeSlots.push_back(slot);
+}
+
+// Number of per-frame blocks each kernel evaluates per render quantum: one per
+// automated param, plus the listener position for panners, the interpolated
+// coefficients for biquads, the per-frame gain for compressors and the bridge
+// read buffer for worklets.
+static size_t renderBlockCount(Engine::NodeKind kind) {
+  switch (kind) {
+  case Engine::NodeKind::Gain:
+  case Engine::NodeKind::ConstantSource:
+  case Engine::NodeKind::StereoPanner:
+  case Engine::NodeKind::WorkletBridge:
+    return 1;
+  case Engine::NodeKind::Oscillator:
+  case Engine::NodeKind::Delay:
+    return 2;
+  case Engine::NodeKind::BufferSource:
+    return 3;
+  case Engine::NodeKind::BiquadFilter:
+    return 9;
+  case Engine::NodeKind::Compressor:
+    return 6;
+  case Engine::NodeKind::Panner:
+    return 9;
+  default:
+    return 0;
+  }
+}
+
+void Engine::prepareRenderScratch(Node &node, int channels, int frames) {
+  node.input.resize(channels, frames);
+  node.blocks.resize(renderBlockCount(node.kind));
+  for (auto &block : node.blocks) {
+    block.assign(static_cast<size_t>(frames), 0.0f);
+  }
+}
+
 Engine::Node *Engine::findNodeUnlocked(int32_t nodeId) {
-  auto it = nodes.find(nodeId);
-  return it == nodes.end() ? nullptr : &it->second;
+  return const_cast<Node *>(
+      static_cast<const Engine *>(this)->findNodeUnlocked(nodeId));
 }
 
 const Engine::Node *Engine::findNodeUnlocked(int32_t nodeId) const {
-  auto it = nodes.find(nodeId);
-  return it == nodes.end() ? nullptr : &it->second;
+  if (nodeId < 0) {
+    return nullptr;
+  }
+  const uint32_t handle = static_cast<uint32_t>(nodeId);
+  const uint32_t slot = handle & kNodeSlotMask;
+  if (slot >= nodeSlots.size() || handleRoute(nodeId) != nodeRoute) {
+    return nullptr;
+  }
+  const auto &entry = nodeSlots[slot];
+  if (!entry.node ||
+      ((handle >> kNodeSlotBits) & kNodeGenerationMask) != entry.generation) {
+    return nullptr;
+  }
+  return entry.node.get();
+}
+
+Engine::Node *Engine::findNodeUnlocked(int32_t nodeId, NodeKind kind) {
+  auto *node = findNodeUnlocked(nodeId);
+  return node && node->kind == kind ? node : nullptr;
 }
 
 bool Engine::containsNode(int32_t nodeId) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  return nodes.find(nodeId) != nodes.end();
+  return findNodeUnlocked(nodeId) != nullptr;
+}
+
+int32_t Engine::paramIndexUnlocked(Node &node, const char *param) {
+  // Unnamed slots are free worklet slots, so an empty name never matches.
+  if (!param || !*param) {
+    return -1;
+  }
+  for (size_t i = 0; i < node.params.size(); ++i) {
+    if (node.params[i].name == param) {
+      return static_cast<int32_t>(i);
+    }
+  }
+  // Worklet bridges, whose params live on the Dart side, name a free slot of
+  // their preallocated table. Names are control-side only, so this never
+  // touches anything the render thread reads.
+  if (node.kind != NodeKind::WorkletBridge) {
+    return -1;
+  }
+  for (size_t i = 0; i < node.params.size(); ++i) {
+    if (node.params[i].name.empty()) {
+      node.params[i].name = param;
+      return static_cast<int32_t>(i);
+    }
+  }
+  return -1;
+}
+
+int32_t Engine::paramIndex(int32_t nodeId, const char *param) {
+  std::lock_guard<std::recursive_mutex> lock(graphMtx);
+  auto *node = findNodeUnlocked(nodeId);
+  return node ? paramIndexUnlocked(*node, param) : -1;
 }
 
-ParamTimeline &Engine::timelineFor(Node &node, const std::string &param) {
-  auto it = node.timelines.find(param);
-  if (it == node.timelines.end()) {
-    auto timeline = std::make_unique<ParamTimeline>();
-    timeline->setLastValue(currentParam(node, param.c_str(), 0.0f));
-    it = node.timelines.emplace(param, std::move(timeline)).first;
+ParamTimeline *Engine::timelineFor(Node &node, int32_t param) {
+  if (param < 0 || static_cast<size_t>(param) >= node.params.size()) {
+    return nullptr;
   }
-  return *it->second;
+  return node.params[static_cast<size_t>(param)].timeline.get();
 }
 
-float Engine::currentParam(Node &node, const char *param, float fallback) {
-  auto it = node.paramValues.find(param);
-  return it == node.paramValues.end() ? fallback : it->second;
+float Engine::currentParam(Node &node, int32_t param, float fallback) {
+  const auto *timeline = timelineFor(node, param);
+  return timeline ? timeline->getLastValue() : fallback;
 }
 
-void Engine::paramBlock(Node &node, const char *param, float fallback,
+bool Engine::paramBlock(Node &node, int32_t param, float fallback,
                         double blockStart, int frames,
-                        std::vector<int32_t> &stack,
                         std::vector<float> &values) {
   values.resize(static_cast<size_t>(frames));
-  auto it = node.timelines.find(param);
-  if (it == node.timelines.end()) {
-    std::fill(values.begin(), values.end(), currentParam(node, param, fallback));
+  if (frames <= 0) {
+    return true;
+  }
+  const double sr = sampleRate.load(std::memory_order_relaxed);
+  auto *timeline = timelineFor(node, param);
+  if (timeline && timeline->isKRate()) {
+    // Stepping the timeline once per quantum samples it at the quantum start
+    // and keeps setTarget decays on the block clock.
+    float value = fallback;
+    timeline->processBlock(blockStart, sr / frames, 1, &value);
+    addParamInputBlock(node, param, &value, 1);
+    std::fill(values.begin(), values.end(), value);
+    return true;
+  }
+
+  bool constant = true;
+  if (timeline) {
+    timeline->processBlock(blockStart, sr, frames, values.data(), &constant);
   } else {
-    const float endValue = it->second->processBlock(
-        blockStart, sampleRate.load(std::memory_order_relaxed), frames,
-        values.data());
-    node.paramValues[param] = endValue;
+    std::fill(values.begin(), values.end(), fallback);
   }
-  addParamInputBlock(node, param, stack, values);
+  if (addParamInputBlock(node, param, values.data(), frames)) {
+    constant = false;
+  }
+  return constant;
 }
 
-void Engine::addParamInputBlock(Node &node, const char *param,
-                                std::vector<int32_t> &stack,
-                                std::vector<float> &values) {
-  if (!param || values.empty()) {
-    return;
+bool Engine::addParamInputBlock(Node &node, int32_t param, float *values,
+                                int frames) {
+  if (param < 0 || frames <= 0 || !node.step) {
+    return false;
   }
 
-  for (const auto &connection : paramConnections) {
-    if (connection.dst != node.id || connection.param != param) {
+  bool added = false;
+
+  for (const auto &route : node.step->params) {
+    if (route.param != param) {
       continue;
     }
 
-    const bool cycle = std::find(stack.begin(), stack.end(), connection.src) !=
-                       stack.end();
-    const AudioBus *srcBus = nullptr;
-    if (cycle) {
-      if (const auto *srcNode = findNodeUnlocked(connection.src)) {
-        srcBus = &srcNode->previous;
-      }
-    } else {
-      srcBus = &renderNode(connection.src, stack);
-    }
-    if (!srcBus || srcBus->frames <= 0 || srcBus->channels <= 0) {
+    const AudioBus *srcBus =
+        route.feedback ? &route.src->previous : &route.src->output();
+    if (srcBus->frames <= 0 || srcBus->channels <= 0 || srcBus->silent) {
       continue;
     }
 
-    const int frames = std::min<int>(renderFrames, srcBus->frames);
-    if (connection.output > 0) {
-      const int srcCh = std::min(connection.output, srcBus->channels - 1);
+    const int count = std::min(frames, srcBus->frames);
+    added = true;
+    if (route.output > 0) {
+      const int srcCh = std::min(route.output, srcBus->channels - 1);
       const float *src = srcBus->channel(srcCh);
       if (!src) {
         continue;
       }
-      for (int i = 0; i < frames; ++i) {
-        values[static_cast<size_t>(i)] += src[i];
-      }
+      wajuce::vec::add(src, values, count);
       continue;
     }
 
@@ -304,121 +715,131 @@ void Engine::addParamInputBlock(Node &node, const char *param,
       if (!src) {
         continue;
       }
-      for (int i = 0; i < frames; ++i) {
-        values[static_cast<size_t>(i)] += src[i] * scale;
-      }
+      wajuce::vec::multiplyAdd(src, scale, values, count);
     }
   }
+  return added;
 }
 
 int32_t Engine::createGain() {
-  Node node;
-  node.kind = NodeKind::Gain;
-  setDefaultParam(node, "gain", 1.0f);
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::Gain;
+  setDefaultParam(*node, kGainGain, "gain", 1.0f);
   return addNode(std::move(node));
 }
 
 int32_t Engine::createOscillator() {
-  Node node;
-  node.kind = NodeKind::Oscillator;
-  node.inputCount = 0;
-  setDefaultParam(node, "frequency", 440.0f);
-  setDefaultParam(node, "detune", 0.0f);
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::Oscillator;
+  node->oscillator = std::make_unique<OscillatorState>();
+  node->inputCount = 0;
+  // Build the shared tables here rather than in the first render quantum.
+  basicWavetable(0);
+  setDefaultParam(*node, kOscFrequency, "frequency", 440.0f);
+  setDefaultParam(*node, kOscDetune, "detune", 0.0f);
   return addNode(std::move(node));
 }
 
 int32_t Engine::createBiquadFilter() {
-  Node node;
-  node.kind = NodeKind::BiquadFilter;
-  setDefaultParam(node, "frequency", 350.0f);
-  setDefaultParam(node, "detune", 0.0f);
-  setDefaultParam(node, "Q", 1.0f);
-  setDefaultParam(node, "gain", 0.0f);
-  node.biquad.resize(static_cast<size_t>(renderChannels));
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::BiquadFilter;
+  node->filter = std::make_unique<FilterState>();
+  setDefaultParam(*node, kBiquadFrequency, "frequency", 350.0f);
+  setDefaultParam(*node, kBiquadDetune, "detune", 0.0f);
+  setDefaultParam(*node, kBiquadQ, "Q", 1.0f);
+  setDefaultParam(*node, kBiquadGain, "gain", 0.0f);
+  node->filter->biquad.resize(static_cast<size_t>(outputChannels.load()));
   return addNode(std::move(node));
 }
 
 int32_t Engine::createCompressor() {
-  Node node;
-  node.kind = NodeKind::Compressor;
-  setDefaultParam(node, "threshold", -24.0f);
-  setDefaultParam(node, "knee", 30.0f);
-  setDefaultParam(node, "ratio", 12.0f);
-  setDefaultParam(node, "attack", 0.003f);
-  setDefaultParam(node, "release", 0.25f);
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::Compressor;
+  node->compressor = std::make_unique<CompressorState>();
+  setDefaultParam(*node, kCompressorThreshold, "threshold", -24.0f, true);
+  setDefaultParam(*node, kCompressorKnee, "knee", 30.0f, true);
+  setDefaultParam(*node, kCompressorRatio, "ratio", 12.0f, true);
+  setDefaultParam(*node, kCompressorAttack, "attack", 0.003f, true);
+  setDefaultParam(*node, kCompressorRelease, "release", 0.25f, true);
   return addNode(std::move(node));
 }
 
 int32_t Engine::createDelay(float maxDelay) {
-  Node node;
-  node.kind = NodeKind::Delay;
-  node.maxDelay = std::max(0.001f, maxDelay);
-  setDefaultParam(node, "delayTime", 0.0f);
-  setDefaultParam(node, "feedback", 0.0f);
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::Delay;
+  node->delay = std::make_unique<DelayState>();
+  node->delay->maxDelay = std::max(0.001f, maxDelay);
+  setDefaultParam(*node, kDelayTime, "delayTime", 0.0f);
+  setDefaultParam(*node, kDelayFeedback, "feedback", 0.0f);
   const int maxFrames =
-      static_cast<int>(std::ceil(node.maxDelay * getSampleRate())) +
+      static_cast<int>(std::ceil(node->delay->maxDelay * getSampleRate())) +
       bufferSize.load() + 8;
-  node.delayLines.resize(static_cast<size_t>(renderChannels));
-  for (auto &line : node.delayLines) {
+  node->delay->delayLines.resize(static_cast<size_t>(outputChannels.load()));
+  for (auto &line : node->delay->delayLines) {
     line.assign(static_cast<size_t>(std::max(1, maxFrames)), 0.0f);
   }
   return addNode(std::move(node));
 }
 
 int32_t Engine::createBufferSource() {
-  Node node;
-  node.kind = NodeKind::BufferSource;
-  node.inputCount = 0;
-  setDefaultParam(node, "playbackRate", 1.0f);
-  setDefaultParam(node, "detune", 0.0f);
-  setDefaultParam(node, "decay", kNeutralDecaySeconds);
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::BufferSource;
+  node->source = std::make_unique<BufferSourceState>();
+  node->inputCount = 0;
+  setDefaultParam(*node, kSourcePlaybackRate, "playbackRate", 1.0f, true);
+  setDefaultParam(*node, kSourceDetune, "detune", 0.0f, true);
+  setDefaultParam(*node, kSourceDecay, "decay", kNeutralDecaySeconds);
   return addNode(std::move(node));
 }
 
 int32_t Engine::createAnalyser() {
-  Node node;
-  node.kind = NodeKind::Analyser;
-  node.analyserTime.assign(2048, 0.0f);
-  node.analyserPreviousDb.assign(1024, -100.0f);
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::Analyser;
+  node->analyser = std::make_unique<AnalyserState>();
+  node->analyser->analyserTime.assign(2048, 0.0f);
+  node->analyser->analyserPreviousDb.assign(1024, -100.0f);
   return addNode(std::move(node));
 }
 
 int32_t Engine::createStereoPanner() {
-  Node node;
-  node.kind = NodeKind::StereoPanner;
-  setDefaultParam(node, "pan", 0.0f);
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::StereoPanner;
+  setDefaultParam(*node, kStereoPannerPan, "pan", 0.0f);
   return addNode(std::move(node));
 }
 
 int32_t Engine::createPanner() {
-  Node node;
-  node.kind = NodeKind::Panner;
-  setDefaultParam(node, "positionX", 0.0f);
-  setDefaultParam(node, "positionY", 0.0f);
-  setDefaultParam(node, "positionZ", 0.0f);
-  setDefaultParam(node, "orientationX", 1.0f);
-  setDefaultParam(node, "orientationY", 0.0f);
-  setDefaultParam(node, "orientationZ", 0.0f);
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::Panner;
+  node->panner = std::make_unique<PannerState>();
+  setDefaultParam(*node, kPannerPositionX, "positionX", 0.0f);
+  setDefaultParam(*node, kPannerPositionY, "positionY", 0.0f);
+  setDefaultParam(*node, kPannerPositionZ, "positionZ", 0.0f);
+  setDefaultParam(*node, kPannerOrientationX, "orientationX", 1.0f);
+  setDefaultParam(*node, kPannerOrientationY, "orientationY", 0.0f);
+  setDefaultParam(*node, kPannerOrientationZ, "orientationZ", 0.0f);
   return addNode(std::move(node));
 }
 
 int32_t Engine::createWaveShaper() {
-  Node node;
-  node.kind = NodeKind::WaveShaper;
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::WaveShaper;
+  node->shaper = std::make_unique<WaveShaperState>();
   return addNode(std::move(node));
 }
 
 int32_t Engine::createConstantSource() {
-  Node node;
-  node.kind = NodeKind::ConstantSource;
-  node.inputCount = 0;
-  setDefaultParam(node, "offset", 1.0f);
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::ConstantSource;
+  node->inputCount = 0;
+  setDefaultParam(*node, kConstantOffset, "offset", 1.0f);
   return addNode(std::move(node));
 }
 
 int32_t Engine::createConvolver() {
-  Node node;
-  node.kind = NodeKind::Convolver;
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::Convolver;
+  node->convolver = std::make_unique<ConvolverState>();
   return addNode(std::move(node));
 }
 
@@ -430,59 +851,73 @@ int32_t Engine::createIIRFilter(const double *feedforward,
       std::abs(feedback[0]) < 1.0e-12) {
     return -1;
   }
-  Node node;
-  node.kind = NodeKind::IIRFilter;
-  node.iirFeedforward.assign(feedforward, feedforward + feedforwardLen);
-  node.iirFeedback.assign(feedback, feedback + feedbackLen);
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::IIRFilter;
+  node->iir = std::make_unique<IIRState>();
+  node->iir->iirFeedforward.assign(feedforward, feedforward + feedforwardLen);
+  node->iir->iirFeedback.assign(feedback, feedback + feedbackLen);
+  const auto channels = static_cast<size_t>(outputChannels.load());
+  node->iir->iirInputHistory.assign(
+      channels, std::vector<float>(static_cast<size_t>(feedforwardLen), 0.0f));
+  node->iir->iirOutputHistory.assign(
+      channels, std::vector<float>(static_cast<size_t>(feedbackLen), 0.0f));
   return addNode(std::move(node));
 }
 
 int32_t Engine::createChannelSplitter(int32_t outputs) {
-  Node node;
-  node.kind = NodeKind::ChannelSplitter;
-  node.outputCount = std::max<int32_t>(1, outputs);
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::ChannelSplitter;
+  node->outputCount = std::max<int32_t>(1, outputs);
   return addNode(std::move(node));
 }
 
 int32_t Engine::createChannelMerger(int32_t inputs) {
-  Node node;
-  node.kind = NodeKind::ChannelMerger;
-  node.inputCount = std::max<int32_t>(1, inputs);
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::ChannelMerger;
+  node->inputCount = std::max<int32_t>(1, inputs);
   return addNode(std::move(node));
 }
 
 int32_t Engine::createMediaStreamSource() {
-  Node node;
-  node.kind = NodeKind::MediaStreamSource;
-  node.inputCount = 0;
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::MediaStreamSource;
+  node->inputCount = 0;
   const int32_t id = addNode(std::move(node));
   requestMediaInput();
   return id;
 }
 
 int32_t Engine::createMediaStreamDestination() {
-  Node node;
-  node.kind = NodeKind::MediaStreamDestination;
-  node.outputCount = 0;
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::MediaStreamDestination;
+  node->outputCount = 0;
   return addNode(std::move(node));
 }
 
 int32_t Engine::createWorkletBridge(int32_t inputs, int32_t outputs) {
-  Node node;
-  node.kind = NodeKind::WorkletBridge;
-  node.inputCount = std::max<int32_t>(0, inputs);
-  node.outputCount = std::max<int32_t>(1, outputs);
+  auto node = std::make_unique<Node>();
+  node->kind = NodeKind::WorkletBridge;
+  node->inputCount = std::max<int32_t>(0, inputs);
+  node->outputCount = std::max<int32_t>(1, outputs);
   const int capacity = std::max(2048, bufferSize.load() * 8);
-  node.bridge = std::make_shared<WorkletBridgeState>();
-  node.bridge->inputChannels = std::max<int32_t>(1, inputs);
-  node.bridge->outputChannels = std::max<int32_t>(1, outputs);
-  node.bridge->capacity = capacity;
-  node.bridge->toIsolate = std::make_shared<MultiChannelSPSCRingBuffer>(
-      node.bridge->inputChannels, capacity);
-  node.bridge->fromIsolate = std::make_shared<MultiChannelSPSCRingBuffer>(
-      node.bridge->outputChannels, capacity);
-  node.workletLastOutput.assign(
-      static_cast<size_t>(node.bridge->outputChannels), 0.0f);
+  auto bridge = std::make_shared<WorkletBridgeState>();
+  bridge->inputChannels = std::max<int32_t>(1, inputs);
+  bridge->outputChannels = std::max<int32_t>(1, outputs);
+  bridge->capacity = capacity;
+  bridge->toIsolate = std::make_shared<MultiChannelSPSCRingBuffer>(
+      bridge->inputChannels, capacity);
+  bridge->fromIsolate = std::make_shared<MultiChannelSPSCRingBuffer>(
+      bridge->outputChannels, capacity);
+  // The render thread walks node.params, so the table is never resized once
+  // the node is in the graph.
+  node->params.resize(kMaxWorkletParams);
+  for (auto &slot : node->params) {
+    slot.timeline = std::make_unique<ParamTimeline>();
+  }
+  node->worklet = std::make_unique<WorkletState>();
+  node->worklet->workletLastOutput.assign(
+      static_cast<size_t>(bridge->outputChannels), 0.0f);
+  node->worklet->bridge = std::move(bridge);
   return addNode(std::move(node));
 }
 
@@ -490,6 +925,8 @@ void Engine::createMachineVoice(int32_t *resultIds) {
   if (!resultIds) {
     return;
   }
+  std::lock_guard<std::recursive_mutex> lock(graphMtx);
+  ++renderPlanBatchDepth;
   resultIds[0] = createOscillator();
   resultIds[1] = createBiquadFilter();
   resultIds[2] = createGain();
@@ -497,23 +934,9 @@ void Engine::createMachineVoice(int32_t *resultIds) {
   resultIds[4] = createDelay(5.0f);
   resultIds[5] = createGain();
   resultIds[6] = createGain();
-  paramSet(resultIds[1], "frequency", 2000.0f);
-  paramSet(resultIds[1], "Q", 1.0f);
-  paramSet(resultIds[2], "gain", 0.0f);
-  paramSet(resultIds[4], "delayTime", 0.3f);
-  paramSet(resultIds[5], "gain", 0.0f);
-  paramSet(resultIds[6], "gain", 0.0f);
-  oscStart(resultIds[0], 0.0);
 
-  connect(resultIds[0], resultIds[1], 0, 0);
-  connect(resultIds[1], resultIds[2], 0, 0);
-  connect(resultIds[2], resultIds[3], 0, 0);
-  connect(resultIds[3], resultIds[4], 0, 0);
-  connect(resultIds[4], resultIds[6], 0, 0);
-  connect(resultIds[4], resultIds[5], 0, 0);
-  connect(resultIds[5], resultIds[4], 0, 0);
-
-  std::lock_guard<std::recursive_mutex> lock(graphMtx);
+  // The voice is not reachable by the render thread until it is connected,
+  // so its render fields can still be written directly here.
   const int32_t root = resultIds[0];
   std::vector<int32_t> ids(resultIds, resultIds + 7);
   auto active = std::make_shared<std::atomic<bool>>(false);
@@ -530,6 +953,26 @@ void Engine::createMachineVoice(int32_t *resultIds) {
   if (auto *node = findNodeUnlocked(resultIds[6])) {
     node->allowSilentInputSkip = true;
   }
+
+  paramSet(resultIds[1], kBiquadFrequency, 2000.0f);
+  paramSet(resultIds[1], kBiquadQ, 1.0f);
+  paramSet(resultIds[2], kGainGain, 0.0f);
+  paramSet(resultIds[4], kDelayTime, 0.3f);
+  paramSet(resultIds[5], kGainGain, 0.0f);
+  paramSet(resultIds[6], kGainGain, 0.0f);
+  oscStart(resultIds[0], 0.0);
+
+  connect(resultIds[0], resultIds[1], 0, 0);
+  connect(resultIds[1], resultIds[2], 0, 0);
+  connect(resultIds[2], resultIds[3], 0, 0);
+  connect(resultIds[3], resultIds[4], 0, 0);
+  connect(resultIds[4], resultIds[6], 0, 0);
+  connect(resultIds[4], resultIds[5], 0, 0);
+  connect(resultIds[5], resultIds[4], 0, 0);
+  --renderPlanBatchDepth;
+  if (renderPlanDirty) {
+    publishRenderPlanUnlocked();
+  }
   {
     std::lock_guard<std::mutex> activeLock(machineVoiceActiveMtx);
     for (auto id : ids) {
@@ -539,7 +982,7 @@ void Engine::createMachineVoice(int32_t *resultIds) {
 }
 
 void Engine::removeNode(int32_t nodeId) {
-  if (nodeId == 0) {
+  if (nodeId == destinationNodeId) {
     return;
   }
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
@@ -554,22 +997,21 @@ void Engine::removeNode(int32_t nodeId) {
   }
   const std::unordered_set<int32_t> removeSet(idsToRemove.begin(),
                                               idsToRemove.end());
-  connections.erase(std::remove_if(connections.begin(), connections.end(),
-                                   [&removeSet](const Connection &c) {
-                                     return removeSet.count(c.src) > 0 ||
-                                            removeSet.count(c.dst) > 0;
-                                   }),
-                    connections.end());
-  paramConnections.erase(
-      std::remove_if(paramConnections.begin(), paramConnections.end(),
-                     [&removeSet](const ParamConnection &c) {
-                       return removeSet.count(c.src) > 0 ||
-                              removeSet.count(c.dst) > 0;
-                     }),
-      paramConnections.end());
+  const auto touchesRemoved = [&removeSet](const auto &c) {
+    return removeSet.count(c.src) > 0 || removeSet.count(c.dst) > 0;
+  };
+  eraseEdgesIf(connections, touchesRemoved);
+  eraseEdgesIf(paramConnections, touchesRemoved);
   for (auto id : idsToRemove) {
-    nodes.erase(id);
+    if (auto node = takeNodeUnlocked(id)) {
+      retireNodeUnlocked(std::move(node));
+    }
   }
+  forEachNodeUnlocked([&touchesRemoved](Node &node) {
+    eraseEdgesIf(node.inputEdges, touchesRemoved);
+    eraseEdgesIf(node.paramInputEdges, touchesRemoved);
+  });
+  markRenderPlanDirtyUnlocked();
   for (auto id : idsToRemove) {
     auto it = machineVoiceRootByNode.find(id);
     if (it != machineVoiceRootByNode.end()) {
@@ -633,12 +1075,12 @@ void Engine::markFeedbackIfCycleUnlocked(int32_t src, int32_t dst) {
 void Engine::connect(int32_t srcId, int32_t dstId, int output, int input) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
   const auto *src = findNodeUnlocked(srcId);
-  const auto *dst = findNodeUnlocked(dstId);
+  auto *dst = findNodeUnlocked(dstId);
   if (!src || !dst || output < 0 || input < 0 || output >= src->outputCount ||
       input >= dst->inputCount) {
     return;
   }
-  for (const auto &connection : connections) {
+  for (const auto &connection : dst->inputEdges) {
     if (connection.src == srcId && connection.dst == dstId &&
         connection.output == output && connection.input == input) {
       return;
@@ -646,39 +1088,45 @@ void Engine::connect(int32_t srcId, int32_t dstId, int output, int input) {
   }
   markFeedbackIfCycleUnlocked(srcId, dstId);
   connections.push_back({srcId, dstId, output, input});
+  dst->inputEdges.push_back(connections.back());
+  markRenderPlanDirtyUnlocked();
 }
 
 void Engine::connectParam(int32_t srcId, int32_t dstId, const char *param,
                           int output) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
   const auto *src = findNodeUnlocked(srcId);
-  const auto *dst = findNodeUnlocked(dstId);
-  if (!src || !dst || !param || output < 0 || output >= src->outputCount ||
-      dst->paramValues.find(param) == dst->paramValues.end()) {
+  auto *dst = findNodeUnlocked(dstId);
+  if (!src || !dst || output < 0 || output >= src->outputCount) {
+    return;
+  }
+  const int32_t index = paramIndexUnlocked(*dst, param);
+  if (index < 0) {
     return;
   }
-  for (const auto &connection : paramConnections) {
+  for (const auto &connection : dst->paramInputEdges) {
     if (connection.src == srcId && connection.dst == dstId &&
-        connection.output == output && connection.param == param) {
+        connection.output == output && connection.param == index) {
       return;
     }
   }
-  paramConnections.push_back({srcId, dstId, param, output});
+  paramConnections.push_back({srcId, dstId, index, output});
+  dst->paramInputEdges.push_back(paramConnections.back());
+  markRenderPlanDirtyUnlocked();
 }
 
 void Engine::disconnect(int32_t srcId, int32_t dstId) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  connections.erase(std::remove_if(connections.begin(), connections.end(),
-                                   [srcId, dstId](const Connection &c) {
-                                     return c.src == srcId && c.dst == dstId;
-                                   }),
-                    connections.end());
-  paramConnections.erase(
-      std::remove_if(paramConnections.begin(), paramConnections.end(),
-                     [srcId, dstId](const ParamConnection &c) {
-                       return c.src == srcId && c.dst == dstId;
-                     }),
-      paramConnections.end());
+  const auto matches = [srcId, dstId](const auto &c) {
+    return c.src == srcId && c.dst == dstId;
+  };
+  eraseEdgesIf(connections, matches);
+  eraseEdgesIf(paramConnections, matches);
+  if (auto *dst = findNodeUnlocked(dstId)) {
+    eraseEdgesIf(dst->inputEdges, matches);
+    eraseEdgesIf(dst->paramInputEdges, matches);
+  }
+  markRenderPlanDirtyUnlocked();
 }
 
 void Engine::disconnectOutput(int32_t srcId, int output) {
@@ -686,18 +1134,16 @@ void Engine::disconnectOutput(int32_t srcId, int output) {
     return;
   }
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  connections.erase(std::remove_if(connections.begin(), connections.end(),
-                                   [srcId, output](const Connection &c) {
-                                     return c.src == srcId &&
-                                            c.output == output;
-                                   }),
-                    connections.end());
-  paramConnections.erase(
-      std::remove_if(paramConnections.begin(), paramConnections.end(),
-                     [srcId, output](const ParamConnection &c) {
-                       return c.src == srcId && c.output == output;
-                     }),
-      paramConnections.end());
+  const auto matches = [srcId, output](const auto &c) {
+    return c.src == srcId && c.output == output;
+  };
+  eraseEdgesIf(connections, matches);
+  eraseEdgesIf(paramConnections, matches);
+  forEachNodeUnlocked([&matches](Node &node) {
+    eraseEdgesIf(node.inputEdges, matches);
+    eraseEdgesIf(node.paramInputEdges, matches);
+  });
+  markRenderPlanDirtyUnlocked();
 }
 
 void Engine::disconnectNodeOutput(int32_t srcId, int32_t dstId, int output) {
@@ -705,12 +1151,14 @@ void Engine::disconnectNodeOutput(int32_t srcId, int32_t dstId, int output) {
     return;
   }
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  connections.erase(std::remove_if(connections.begin(), connections.end(),
-                                   [srcId, dstId, output](const Connection &c) {
-                                     return c.src == srcId && c.dst == dstId &&
-                                            c.output == output;
-                                   }),
-                    connections.end());
+  const auto matches = [srcId, dstId, output](const Connection &c) {
+    return c.src == srcId && c.dst == dstId && c.output == output;
+  };
+  eraseEdgesIf(connections, matches);
+  if (auto *dst = findNodeUnlocked(dstId)) {
+    eraseEdgesIf(dst->inputEdges, matches);
+  }
+  markRenderPlanDirtyUnlocked();
 }
 
 void Engine::disconnectNodeInput(int32_t srcId, int32_t dstId, int output,
@@ -719,13 +1167,15 @@ void Engine::disconnectNodeInput(int32_t srcId, int32_t dstId, int output,
     return;
   }
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  connections.erase(
-      std::remove_if(connections.begin(), connections.end(),
-                     [srcId, dstId, output, input](const Connection &c) {
-                       return c.src == srcId && c.dst == dstId &&
-                              c.output == output && c.input == input;
-                     }),
-      connections.end());
+  const auto matches = [srcId, dstId, output, input](const Connection &c) {
+    return c.src == srcId && c.dst == dstId && c.output == output &&
+           c.input == input;
+  };
+  eraseEdgesIf(connections, matches);
+  if (auto *dst = findNodeUnlocked(dstId)) {
+    eraseEdgesIf(dst->inputEdges, matches);
+  }
+  markRenderPlanDirtyUnlocked();
 }
 
 void Engine::disconnectParam(int32_t srcId, int32_t dstId, const char *param,
@@ -734,173 +1184,235 @@ void Engine::disconnectParam(int32_t srcId, int32_t dstId, const char *param,
     return;
   }
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  paramConnections.erase(
-      std::remove_if(paramConnections.begin(), paramConnections.end(),
-                     [srcId, dstId, param, output](const ParamConnection &c) {
-                       return c.src == srcId && c.dst == dstId &&
-                              c.output == output && c.param == param;
-                     }),
-      paramConnections.end());
+  auto *dst = findNodeUnlocked(dstId);
+  if (!dst) {
+    return;
+  }
+  const int32_t index = paramIndexUnlocked(*dst, param);
+  const auto matches = [srcId, dstId, index, output](const ParamConnection &c) {
+    return c.src == srcId && c.dst == dstId && c.output == output &&
+           c.param == index;
+  };
+  eraseEdgesIf(paramConnections, matches);
+  eraseEdgesIf(dst->paramInputEdges, matches);
+  markRenderPlanDirtyUnlocked();
 }
 
 void Engine::disconnectAll(int32_t srcId) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  connections.erase(std::remove_if(connections.begin(), connections.end(),
-                                   [srcId](const Connection &c) {
-                                     return c.src == srcId;
-                                   }),
-                    connections.end());
-  paramConnections.erase(
-      std::remove_if(paramConnections.begin(), paramConnections.end(),
-                     [srcId](const ParamConnection &c) {
-                       return c.src == srcId;
-                     }),
-      paramConnections.end());
-}
-
-void Engine::paramSet(int32_t nodeId, const char *param, float value) {
+  const auto matches = [srcId](const auto &c) { return c.src == srcId; };
+  eraseEdgesIf(connections, matches);
+  eraseEdgesIf(paramConnections, matches);
+  forEachNodeUnlocked([&matches](Node &node) {
+    eraseEdgesIf(node.inputEdges, matches);
+    eraseEdgesIf(node.paramInputEdges, matches);
+  });
+  markRenderPlanDirtyUnlocked();
+}
+
+// Posts a scheduling call that adds one event. When the timeline could run out
+// of room, larger arrays ride along in the command and come back holding the
+// ones they replaced, to be freed with the command slot.
+template <typename Schedule>
+void Engine::postAutomationUnlocked(ParamTimeline *timeline,
+                                    Schedule schedule) {
+  AutomationStorage storage;
+  timeline->reserveEvent(storage);
+  postCommandUnlocked([timeline, storage = std::move(storage),
+                       schedule = std::move(schedule)]() mutable {
+    timeline->adoptStorage(storage);
+    schedule();
+  });
+}
+
+void Engine::paramSet(int32_t nodeId, int32_t param, float value) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
   if (auto *node = findNodeUnlocked(nodeId)) {
-    node->paramValues[param] = value;
-    timelineFor(*node, param).setLastValue(value);
+    if (auto *timeline = timelineFor(*node, param)) {
+      postCommandUnlocked([timeline, value] { timeline->setLastValue(value); });
+    }
   }
 }
 
-void Engine::paramSetAtTime(int32_t nodeId, const char *param, float value,
+void Engine::paramSetAtTime(int32_t nodeId, int32_t param, float value,
                             double time) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
   if (auto *node = findNodeUnlocked(nodeId)) {
-    node->paramValues[param] = value;
-    timelineFor(*node, param).setValueAtTime(value, time);
+    if (auto *timeline = timelineFor(*node, param)) {
+      postAutomationUnlocked(timeline, [timeline, value, time] {
+        timeline->setValueAtTime(value, time);
+      });
+    }
   }
 }
 
-void Engine::paramLinearRamp(int32_t nodeId, const char *param, float value,
+void Engine::paramLinearRamp(int32_t nodeId, int32_t param, float value,
                              double endTime) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
   if (auto *node = findNodeUnlocked(nodeId)) {
-    node->paramValues[param] = value;
-    timelineFor(*node, param).linearRampToValueAtTime(value, endTime);
+    if (auto *timeline = timelineFor(*node, param)) {
+      postAutomationUnlocked(timeline, [timeline, value, endTime] {
+        timeline->linearRampToValueAtTime(value, endTime);
+      });
+    }
   }
 }
 
-void Engine::paramExpRamp(int32_t nodeId, const char *param, float value,
+void Engine::paramExpRamp(int32_t nodeId, int32_t param, float value,
                           double endTime) {
   if (value <= 0.0f) {
     return;
   }
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
   if (auto *node = findNodeUnlocked(nodeId)) {
-    node->paramValues[param] = value;
-    timelineFor(*node, param).exponentialRampToValueAtTime(value, endTime);
+    if (auto *timeline = timelineFor(*node, param)) {
+      postAutomationUnlocked(timeline, [timeline, value, endTime] {
+        timeline->exponentialRampToValueAtTime(value, endTime);
+      });
+    }
   }
 }
 
-void Engine::paramSetTarget(int32_t nodeId, const char *param, float target,
+void Engine::paramSetTarget(int32_t nodeId, int32_t param, float target,
                             double startTime, float tc) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
   if (auto *node = findNodeUnlocked(nodeId)) {
-    node->paramValues[param] = target;
-    timelineFor(*node, param).setTargetAtTime(target, startTime, tc);
+    if (auto *timeline = timelineFor(*node, param)) {
+      postAutomationUnlocked(timeline, [timeline, target, startTime, tc] {
+        timeline->setTargetAtTime(target, startTime, tc);
+      });
+    }
   }
 }
 
-void Engine::paramCancel(int32_t nodeId, const char *param,
+void Engine::paramCancel(int32_t nodeId, int32_t param,
                          double cancelTime) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
   if (auto *node = findNodeUnlocked(nodeId)) {
-    timelineFor(*node, param).cancelScheduledValues(cancelTime);
+    if (auto *timeline = timelineFor(*node, param)) {
+      postCommandUnlocked([timeline, cancelTime] {
+        timeline->cancelScheduledValues(cancelTime);
+      });
+    }
   }
 }
 
-void Engine::paramCancelAndHold(int32_t nodeId, const char *param,
+void Engine::paramCancelAndHold(int32_t nodeId, int32_t param,
                                 double time) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
   if (auto *node = findNodeUnlocked(nodeId)) {
-    timelineFor(*node, param).cancelAndHoldAtTime(time, getSampleRate());
+    if (auto *timeline = timelineFor(*node, param)) {
+      const double sr = getSampleRate();
+      postAutomationUnlocked(timeline, [timeline, time, sr] {
+        timeline->cancelAndHoldAtTime(time, sr);
+      });
+    }
   }
 }
 
-void Engine::paramSetValueCurve(int32_t nodeId, const char *param,
+void Engine::paramSetValueCurve(int32_t nodeId, int32_t param,
                                 const float *values, int32_t length,
                                 double startTime, double duration) {
+  if (!values || length <= 0 || duration <= 0.0) {
+    return;
+  }
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
   if (auto *node = findNodeUnlocked(nodeId)) {
-    timelineFor(*node, param).setValueCurveAtTime(values, length, startTime,
-                                                  duration);
-    if (values && length > 0) {
-      node->paramValues[param] = values[length - 1];
+    auto *timeline = timelineFor(*node, param);
+    if (!timeline) {
+      return;
     }
+    // The curve is copied here and swapped into the timeline's pool; the
+    // command carries any retired buffer back to be freed off the render
+    // thread.
+    std::vector<float> curve(values, values + length);
+    postAutomationUnlocked(timeline, [timeline, curve = std::move(curve),
+                                      startTime, duration]() mutable {
+      timeline->setValueCurveAtTime(curve, startTime, duration);
+    });
   }
 }
 
-float Engine::paramGet(int32_t nodeId, const char *param) {
+float Engine::paramGet(int32_t nodeId, int32_t param) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (!param) {
-    return 0.0f;
-  }
   if (auto *node = findNodeUnlocked(nodeId)) {
     return currentParam(*node, param, 0.0f);
   }
   return 0.0f;
 }
 
+bool Engine::paramSetAutomationRate(int32_t nodeId, int32_t param,
+                                    bool kRate) {
+  std::lock_guard<std::recursive_mutex> lock(graphMtx);
+  auto *node = findNodeUnlocked(nodeId);
+  auto *timeline = node ? timelineFor(*node, param) : nullptr;
+  if (!timeline) {
+    return false;
+  }
+  if (node->params[static_cast<size_t>(param)].fixedRate) {
+    return kRate == timeline->isKRate();
+  }
+  timeline->setKRate(kRate);
+  return true;
+}
+
 void Engine::oscSetType(int32_t nodeId, int type) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->oscillatorType = std::max(0, std::min(4, type));
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::Oscillator)) {
+    const int clamped = std::max(0, std::min(4, type));
+    postCommandUnlocked(
+        [node, clamped] { node->oscillator->oscillatorType = clamped; });
   }
 }
 
+// Also drives constant sources, which share the start/stop schedule but have
+// no phase to reset.
 void Engine::oscStart(int32_t nodeId, double when) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
   if (auto *node = findNodeUnlocked(nodeId)) {
-    node->phase = 0.0;
-    node->startTime = when;
+    postCommandUnlocked([node, when] {
+      if (node->oscillator) {
+        node->oscillator->phase = 0.0;
+      }
+      node->startTime = when;
+    });
   }
 }
 
 void Engine::oscStop(int32_t nodeId, double when) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
   if (auto *node = findNodeUnlocked(nodeId)) {
-    node->stopTime = when;
+    postCommandUnlocked([node, when] { node->stopTime = when; });
   }
 }
 
 void Engine::oscSetPeriodicWave(int32_t nodeId, const float *real,
                                 const float *imag, int32_t len,
                                 bool disableNormalization) {
-  std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  auto *node = findNodeUnlocked(nodeId);
-  if (!node || !real || !imag || len <= 0) {
+  if (!real || !imag || len <= 0) {
     return;
   }
-  const int tableSize = 2048;
-  node->periodicWave.assign(tableSize, 0.0f);
-  float maxAbs = 0.0f;
-  for (int i = 0; i < tableSize; ++i) {
-    const double phase = (2.0 * kPi * i) / tableSize;
-    double value = 0.0;
-    for (int k = 1; k < len; ++k) {
-      value += real[k] * std::cos(phase * k) + imag[k] * std::sin(phase * k);
-    }
-    const float sample = std::isfinite(value) ? static_cast<float>(value) : 0.0f;
-    node->periodicWave[static_cast<size_t>(i)] = sample;
-    maxAbs = std::max(maxAbs, std::abs(sample));
-  }
-  if (!disableNormalization && maxAbs > kSilentFloor) {
-    const float scale = 1.0f / maxAbs;
-    for (auto &sample : node->periodicWave) {
-      sample *= scale;
-    }
+  // Built, or found in the shared cache, before taking the graph lock so
+  // rendering never waits on the transform.
+  auto wave = sharedPeriodicWave(real, imag, len, !disableNormalization);
+  std::lock_guard<std::recursive_mutex> lock(graphMtx);
+  auto *node = findNodeUnlocked(nodeId, NodeKind::Oscillator);
+  if (!node) {
+    return;
   }
-  node->oscillatorType = 4;
+  // Swapping leaves the previous table in the command slot, which is released
+  // on the control thread when the slot is reused.
+  postCommandUnlocked([node, wave = std::move(wave)]() mutable {
+    node->oscillator->periodicWave.swap(wave);
+    node->oscillator->oscillatorType = 4;
+  });
 }
 
 void Engine::filterSetType(int32_t nodeId, int type) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->filterType = std::max(0, std::min(7, type));
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::BiquadFilter)) {
+    node->filter->filterType.store(std::max(0, std::min(7, type)),
+                           std::memory_order_relaxed);
   }
 }
 
@@ -908,15 +1420,20 @@ void Engine::bufferSourceSetBuffer(int32_t nodeId, const float *data,
                                    int32_t frames, int32_t channels,
                                    int32_t sr) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  auto *node = findNodeUnlocked(nodeId);
+  auto *node = findNodeUnlocked(nodeId, NodeKind::BufferSource);
   if (!node || !data || frames <= 0 || channels <= 0) {
     return;
   }
-  node->sourceFrames = frames;
-  node->sourceChannels = channels;
-  node->sourceSampleRate = sr > 0 ? sr : static_cast<int32_t>(getSampleRate());
-  node->sourceCursor = 0.0;
-  node->sourceBuffer.assign(data, data + static_cast<size_t>(frames * channels));
+  const int32_t sourceSr = sr > 0 ? sr : static_cast<int32_t>(getSampleRate());
+  std::vector<float> buffer(data, data + static_cast<size_t>(frames * channels));
+  postCommandUnlocked([node, frames, channels, sourceSr,
+                       buffer = std::move(buffer)]() mutable {
+    node->source->sourceFrames = frames;
+    node->source->sourceChannels = channels;
+    node->source->sourceSampleRate = sourceSr;
+    node->source->sourceCursor = 0.0;
+    node->source->sourceBuffer.swap(buffer);
+  });
 }
 
 void Engine::bufferSourceStart(int32_t nodeId, double when) {
@@ -926,45 +1443,55 @@ void Engine::bufferSourceStart(int32_t nodeId, double when) {
 void Engine::bufferSourceStart(int32_t nodeId, double when, double offset,
                                double duration, bool hasDuration) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::BufferSource)) {
     const double boundedOffset = std::max(0.0, offset);
-    const double sourceSr =
-        node->sourceSampleRate > 0 ? node->sourceSampleRate : getSampleRate();
-    node->sourceOffset = boundedOffset;
-    node->sourceDuration = std::max(0.0, duration);
-    node->sourceHasDuration = hasDuration;
-    node->sourceCursor = boundedOffset * sourceSr;
-    node->sourceStartTime = when;
-    node->sourceEnvelope = 1.0f;
+    const double boundedDuration = std::max(0.0, duration);
+    const double contextSr = getSampleRate();
+    postCommandUnlocked([node, when, boundedOffset, boundedDuration,
+                         hasDuration, contextSr] {
+      auto &source = *node->source;
+      const double sourceSr =
+          source.sourceSampleRate > 0 ? source.sourceSampleRate : contextSr;
+      source.sourceOffset = boundedOffset;
+      source.sourceDuration = boundedDuration;
+      source.sourceHasDuration = hasDuration;
+      source.sourceCursor = boundedOffset * sourceSr;
+      source.sourceStartTime = when;
+      source.sourceEnvelope = 1.0f;
+    });
   }
 }
 
 void Engine::bufferSourceStop(int32_t nodeId, double when) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->sourceStopTime = when;
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::BufferSource)) {
+    postCommandUnlocked([node, when] { node->source->sourceStopTime = when; });
   }
 }
 
 void Engine::bufferSourceSetLoop(int32_t nodeId, bool loop) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->sourceLoop = loop;
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::BufferSource)) {
+    postCommandUnlocked([node, loop] { node->source->sourceLoop = loop; });
   }
 }
 
 void Engine::bufferSourceSetLoopPoints(int32_t nodeId, double loopStart,
                                        double loopEnd) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->sourceLoopStart = std::max(0.0, loopStart);
-    node->sourceLoopEnd = std::max(0.0, loopEnd);
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::BufferSource)) {
+    const double start = std::max(0.0, loopStart);
+    const double end = std::max(0.0, loopEnd);
+    postCommandUnlocked([node, start, end] {
+      node->source->sourceLoopStart = start;
+      node->source->sourceLoopEnd = end;
+    });
   }
 }
 
 void Engine::analyserSetFftSize(int32_t nodeId, int32_t size) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  auto *node = findNodeUnlocked(nodeId);
+  auto *node = findNodeUnlocked(nodeId, NodeKind::Analyser);
   if (!node) {
     return;
   }
@@ -972,31 +1499,39 @@ void Engine::analyserSetFftSize(int32_t nodeId, int32_t size) {
   while (fft < size && fft < 32768) {
     fft <<= 1;
   }
-  node->analyserFftSize = fft;
-  node->analyserTime.assign(static_cast<size_t>(fft), 0.0f);
-  node->analyserPreviousDb.assign(static_cast<size_t>(fft / 2), -100.0f);
+  auto &analyser = *node->analyser;
+  std::lock_guard<std::mutex> analyserLock(analyser.analyserMtx);
+  analyser.analyserFftSize = fft;
+  analyser.analyserTime.assign(static_cast<size_t>(fft), 0.0f);
+  analyser.analyserWrite = 0;
+  analyser.analyserPreviousDb.assign(static_cast<size_t>(fft / 2), -100.0f);
 }
 
 void Engine::analyserSetMinDecibels(int32_t nodeId, double value) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->analyserMinDecibels =
-        std::min(static_cast<float>(value), node->analyserMaxDecibels - 0.001f);
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::Analyser)) {
+    auto &analyser = *node->analyser;
+    std::lock_guard<std::mutex> analyserLock(analyser.analyserMtx);
+    analyser.analyserMinDecibels = std::min(
+        static_cast<float>(value), analyser.analyserMaxDecibels - 0.001f);
   }
 }
 
 void Engine::analyserSetMaxDecibels(int32_t nodeId, double value) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->analyserMaxDecibels =
-        std::max(static_cast<float>(value), node->analyserMinDecibels + 0.001f);
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::Analyser)) {
+    auto &analyser = *node->analyser;
+    std::lock_guard<std::mutex> analyserLock(analyser.analyserMtx);
+    analyser.analyserMaxDecibels = std::max(
+        static_cast<float>(value), analyser.analyserMinDecibels + 0.001f);
   }
 }
 
 void Engine::analyserSetSmoothingTimeConstant(int32_t nodeId, double value) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->analyserSmoothing =
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::Analyser)) {
+    std::lock_guard<std::mutex> analyserLock(node->analyser->analyserMtx);
+    node->analyser->analyserSmoothing =
         clampFloat(static_cast<float>(value), 0.0f, 1.0f);
   }
 }
@@ -1004,67 +1539,246 @@ void Engine::analyserSetSmoothingTimeConstant(int32_t nodeId, double value) {
 void Engine::waveShaperSetCurve(int32_t nodeId, const float *data,
                                 int32_t len) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  auto *node = findNodeUnlocked(nodeId);
+  auto *node = findNodeUnlocked(nodeId, NodeKind::WaveShaper);
   if (!node || !data || len <= 0) {
     return;
   }
-  node->waveShaperCurve.assign(data, data + len);
+  std::vector<float> curve(data, data + len);
+  // Silent input maps to the curve's midpoint, so only a curve through zero
+  // keeps silence silent.
+  const bool zeroAtRest = shapeWithCurve(curve, 0.0f) == 0.0f;
+  postCommandUnlocked([node, zeroAtRest,
+                       curve = std::move(curve)]() mutable {
+    node->shaper->waveShaperCurve.swap(curve);
+    node->shaper->waveShaperZeroAtRest = zeroAtRest;
+  });
 }
 
 void Engine::waveShaperSetOversample(int32_t nodeId, int type) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->waveShaperOversample = std::max(0, std::min(2, type));
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::WaveShaper)) {
+    const int clamped = std::max(0, std::min(2, type));
+    postCommandUnlocked(
+        [node, clamped] { node->shaper->waveShaperOversample = clamped; });
   }
 }
 
 void Engine::convolverSetNormalize(int32_t nodeId, bool normalize) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->convolverNormalize = normalize;
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::Convolver)) {
+    postCommandUnlocked(
+        [node, normalize] { node->convolver->convolverNormalize = normalize; });
+  }
+}
+
+// Band-limited resampling of a planar response with a Blackman-windowed
+// sinc; when the rate drops the cutoff drops with it.
+static std::vector<float> resampleResponse(const std::vector<float> &buffer,
+                                           int frames, int channels,
+                                           double fromRate, double toRate,
+                                           int &outFrames) {
+  constexpr int kZeroCrossings = 16;
+  const double ratio = toRate / fromRate;
+  outFrames = std::max(1, static_cast<int>(std::ceil(frames * ratio)));
+  const double cutoff = std::min(1.0, ratio);
+  const double width = kZeroCrossings / cutoff;
+  std::vector<float> out(static_cast<size_t>(outFrames * channels), 0.0f);
+  for (int ch = 0; ch < channels; ++ch) {
+    const float *in = buffer.data() + static_cast<size_t>(ch * frames);
+    float *dst = out.data() + static_cast<size_t>(ch * outFrames);
+    for (int j = 0; j < outFrames; ++j) {
+      const double center = j / ratio;
+      const int first =
+          std::max(0, static_cast<int>(std::ceil(center - width)));
+      const int last =
+          std::min(frames - 1, static_cast<int>(std::floor(center + width)));
+      double sum = 0.0;
+      for (int i = first; i <= last; ++i) {
+        const double x = center - i;
+        const double arg = kPi * cutoff * x;
+        const double sinc = std::abs(arg) < 1.0e-9 ? 1.0 : std::sin(arg) / arg;
+        const double w = 0.5 + 0.5 * (x / width);
+        const double window = 0.42 - 0.5 * std::cos(2.0 * kPi * w) +
+                              0.08 * std::cos(4.0 * kPi * w);
+        sum += in[i] * cutoff * sinc * window;
+      }
+      dst[j] = static_cast<float>(sum);
+    }
   }
+  return out;
+}
+
+// Crossfades from the current response to the pending one. The outgoing
+// engine fades out from wherever it is, and the one that had finished fading
+// out is parked in the pending slot together with the outgoing kernel.
+static void startPendingResponse(Engine::ConvolverState &conv) {
+  if (conv.convolverKernel) {
+    std::swap(conv.convolverFading, conv.convolverEngine);
+    conv.convolverFadeLength = conv.convolverPendingFadeLength;
+    conv.convolverFadeFrames = conv.convolverPendingFadeLength;
+  }
+  std::swap(conv.convolverEngine, conv.convolverPending);
+  conv.convolverKernel.swap(conv.convolverPendingKernel);
+  conv.convolverPendingReady = false;
 }
 
 void Engine::convolverSetBuffer(int32_t nodeId, const float *data,
                                 int32_t frames, int32_t channels, int32_t sr,
                                 bool normalize) {
+  std::vector<float> buffer;
+  if (!data || frames <= 0 || channels <= 0) {
+    frames = 0;
+    channels = 0;
+  } else {
+    buffer.assign(data, data + static_cast<size_t>(frames * channels));
+  }
+  uint64_t request = 0;
+  {
+    std::lock_guard<std::recursive_mutex> lock(graphMtx);
+    auto *node = findNodeUnlocked(nodeId, NodeKind::Convolver);
+    if (!node) {
+      return;
+    }
+    request = ++node->convolver->convolverRequest;
+  }
+
+  // Resampling, normalisation and partitioning run as a preparation job; the
+  // render thread only swaps the result in and crossfades to it.
+  runPreparation([this, nodeId, request, buffer = std::move(buffer), frames,
+                  channels, sr, normalize]() mutable {
+    const double contextSr = getSampleRate();
+    const int32_t irSr = sr > 0 ? sr : static_cast<int32_t>(contextSr);
+    if (frames > 0 && irSr != static_cast<int32_t>(contextSr)) {
+      int resampledFrames = 0;
+      buffer = resampleResponse(buffer, frames, channels, irSr, contextSr,
+                                resampledFrames);
+      frames = resampledFrames;
+    }
+    if (normalize && !buffer.empty()) {
+      double energy = 0.0;
+      for (float sample : buffer) {
+        energy += static_cast<double>(sample) * sample;
+      }
+      if (energy > kSilentFloor) {
+        const float scale = static_cast<float>(1.0 / std::sqrt(energy));
+        for (auto &sample : buffer) {
+          sample *= scale;
+        }
+      }
+    }
+    std::shared_ptr<const ConvolverKernel> kernel;
+    if (frames > 0) {
+      kernel =
+          std::make_shared<ConvolverKernel>(buffer.data(), frames, channels);
+    }
+    const int fadeLength =
+        static_cast<int>(std::ceil(contextSr * kConvolverCrossfadeSeconds));
+
+    // Partition for the current render channel count, again if it changes
+    // while the lock is released.
+    PartitionedConvolver engine;
+    int engineChannels = 0;
+    Node *node = nullptr;
+    std::unique_lock<std::recursive_mutex> lock(graphMtx);
+    while (true) {
+      node = findNodeUnlocked(nodeId, NodeKind::Convolver);
+      if (!node || node->convolver->convolverRequest != request) {
+        return;
+      }
+      const int wanted = preparedChannelCount.load(std::memory_order_relaxed);
+      if (engineChannels == wanted) {
+        break;
+      }
+      engineChannels = wanted;
+      lock.unlock();
+      engine.prepare(kernel, engineChannels);
+      lock.lock();
+    }
+    node->convolver->convolverPostedKernel = kernel;
+    node->convolver->convolverPostedChannels = engineChannels;
+    postCommandUnlocked([node, frames, channels, irSr, normalize, fadeLength,
+                         kernel = std::move(kernel),
+                         engine = std::move(engine)]() mutable {
+      auto &conv = *node->convolver;
+      conv.convolverNormalize = normalize;
+      conv.convolverFrames = frames;
+      conv.convolverChannels = channels;
+      if (frames > 0) {
+        conv.convolverSampleRate = irSr;
+      }
+      // Whatever sat in the pending slot, a parked engine or a response that
+      // never got to play, is left in the command slot and freed on the
+      // control thread when the slot is reused.
+      conv.convolverPendingKernel.swap(kernel);
+      std::swap(conv.convolverPending, engine);
+      conv.convolverPendingFadeLength = fadeLength;
+      conv.convolverPendingReady = true;
+      // A fade in progress runs to its end first; renderConvolver starts
+      // this one after it, so neither response is cut off.
+      if (conv.convolverFadeFrames <= 0) {
+        startPendingResponse(conv);
+      }
+    });
+  });
+}
+
+// Called by whoever drives render() before it changes the channel count; for
+// offline renders that is the control thread itself.
+void Engine::prepareRenderChannels(int32_t channels) {
+  channels = std::max(1, channels);
+  if (preparedChannelCount.load(std::memory_order_relaxed) == channels) {
+    return;
+  }
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  auto *node = findNodeUnlocked(nodeId);
+  preparedChannelCount.store(channels, std::memory_order_relaxed);
+  forEachNodeUnlocked([this](Node &node) {
+    if (node.kind == NodeKind::Convolver &&
+        node.convolver->convolverPostedKernel) {
+      const int32_t nodeId = node.id;
+      runPreparation([this, nodeId] { prepareConvolverChannels(nodeId); });
+    } else if (node.kind == NodeKind::Compressor &&
+               node.compressor->compressorLookaheadFrames > 0) {
+      postCompressorLookaheadUnlocked(node);
+    }
+  });
+}
+
+// Re-partitions the posted response for the current channel count. A pending
+// setBuffer job prepares its own response for the new count instead.
+void Engine::prepareConvolverChannels(int32_t nodeId) {
+  std::unique_lock<std::recursive_mutex> lock(graphMtx);
+  auto *node = findNodeUnlocked(nodeId, NodeKind::Convolver);
   if (!node) {
     return;
   }
-  node->convolverNormalize = normalize;
-  node->convolverHistory.clear();
-  node->convolverWrite = 0;
-  if (!data || frames <= 0 || channels <= 0) {
-    node->convolverBuffer.clear();
-    node->convolverFrames = 0;
-    node->convolverChannels = 0;
+  auto kernel = node->convolver->convolverPostedKernel;
+  const int channels = preparedChannelCount.load(std::memory_order_relaxed);
+  if (!kernel || node->convolver->convolverPostedChannels == channels) {
     return;
   }
-  node->convolverFrames = frames;
-  node->convolverChannels = channels;
-  node->convolverSampleRate = sr > 0 ? sr : static_cast<int32_t>(getSampleRate());
-  node->convolverBuffer.assign(data, data + static_cast<size_t>(frames * channels));
-  if (normalize) {
-    double energy = 0.0;
-    for (float sample : node->convolverBuffer) {
-      energy += static_cast<double>(sample) * sample;
-    }
-    if (energy > kSilentFloor) {
-      const float scale = static_cast<float>(1.0 / std::sqrt(energy));
-      for (auto &sample : node->convolverBuffer) {
-        sample *= scale;
-      }
-    }
+  lock.unlock();
+  PartitionedConvolver engine;
+  engine.prepare(kernel, channels);
+  lock.lock();
+  node = findNodeUnlocked(nodeId, NodeKind::Convolver);
+  if (!node || node->convolver->convolverPostedKernel != kernel ||
+      preparedChannelCount.load(std::memory_order_relaxed) != channels) {
+    return;
   }
+  node->convolver->convolverPostedChannels = channels;
+  postCommandUnlocked([node, engine = std::move(engine)]() mutable {
+    auto &conv = *node->convolver;
+    std::swap(conv.convolverPendingReady ? conv.convolverPending
+                                         : conv.convolverEngine,
+              engine);
+  });
 }
 
 std::shared_ptr<WorkletBridgeState>
 Engine::getWorkletBridgeState(int32_t nodeId) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  auto *node = findNodeUnlocked(nodeId);
-  return node ? node->bridge : nullptr;
+  auto *node = findNodeUnlocked(nodeId, NodeKind::WorkletBridge);
+  return node ? node->worklet->bridge : nullptr;
 }
 
 int32_t Engine::getWorkletBridgeInputChannelCount(int32_t nodeId) {
@@ -1084,11 +1798,12 @@ int32_t Engine::getWorkletBridgeCapacity(int32_t nodeId) {
 
 void Engine::releaseWorkletBridge(int32_t nodeId) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId); node && node->bridge) {
-    node->bridge->active.store(false, std::memory_order_release);
-    const auto dropped = node->bridge->droppedInputSamples.load(
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::WorkletBridge);
+      node && node->worklet->bridge) {
+    node->worklet->bridge->active.store(false, std::memory_order_release);
+    const auto dropped = node->worklet->bridge->droppedInputSamples.load(
         std::memory_order_relaxed);
-    const auto underruns = node->bridge->outputUnderrunSamples.load(
+    const auto underruns = node->worklet->bridge->outputUnderrunSamples.load(
         std::memory_order_relaxed);
     if (dropped > 0 || underruns > 0) {
       WA_LOG("WorkletBridge stats bridge=%d droppedIn=%lld underrunOut=%lld",
@@ -1098,114 +1813,666 @@ void Engine::releaseWorkletBridge(int32_t nodeId) {
   }
 }
 
-void Engine::sumInputs(Node &node, std::vector<int32_t> &stack,
-                       AudioBus &input) {
+void Engine::sumInputs(Node &node, AudioBus &input) {
   input.resize(renderChannels, renderFrames);
   input.clear();
+  input.silent = inputsSilent(node);
 
-  for (const auto &connection : connections) {
-    if (connection.dst != node.id) {
-      continue;
-    }
-    const bool cycle = std::find(stack.begin(), stack.end(), connection.src) !=
-                       stack.end();
-    const AudioBus *srcBus = nullptr;
-    if (cycle) {
-      if (const auto *srcNode = findNodeUnlocked(connection.src)) {
-        srcBus = &srcNode->previous;
-      }
-    } else {
-      srcBus = &renderNode(connection.src, stack);
-    }
-    if (!srcBus || srcBus->frames <= 0) {
+  if (!node.step || input.silent) {
+    return;
+  }
+  for (const auto &route : node.step->inputs) {
+    const AudioBus *srcBus =
+        route.feedback ? &route.src->previous : &route.src->output();
+    if (srcBus->frames <= 0) {
       continue;
     }
 
-    if (node.kind == NodeKind::ChannelMerger || connection.output > 0 ||
-        connection.input > 0) {
-      const int srcCh = std::min(connection.output, srcBus->channels - 1);
-      const int dstCh = std::min(connection.input, input.channels - 1);
+    if (node.kind == NodeKind::ChannelMerger || route.output > 0 ||
+        route.input > 0) {
+      const int srcCh = std::min(route.output, srcBus->channels - 1);
+      const int dstCh = std::min(route.input, input.channels - 1);
       const float *src = srcBus->channel(srcCh);
       float *dst = input.channel(dstCh);
       if (!src || !dst) {
         continue;
       }
-      for (int i = 0; i < renderFrames; ++i) {
-        dst[i] += src[i];
-      }
+      wajuce::vec::add(src, dst, renderFrames);
       continue;
     }
 
     const int channels = std::min(input.channels, srcBus->channels);
     for (int ch = 0; ch < channels; ++ch) {
-      const float *src = srcBus->channel(ch);
-      float *dst = input.channel(ch);
-      for (int i = 0; i < renderFrames; ++i) {
-        dst[i] += src[i];
-      }
+      wajuce::vec::add(srcBus->channel(ch), input.channel(ch), renderFrames);
     }
   }
 }
 
-bool Engine::canSkipInactiveMachineNodeUnlocked(Node &node) const {
+bool Engine::canSkipInactiveMachineNode(Node &node) const {
   return node.machineActive &&
          !node.machineActive->load(std::memory_order_acquire);
 }
 
-bool Engine::hasParamInputUnlocked(int32_t nodeId, const char *param) const {
-  if (!param) {
+bool Engine::hasParamInput(const Node &node, int32_t param) const {
+  if (param < 0 || !node.step) {
     return false;
   }
-  for (const auto &connection : paramConnections) {
-    if (connection.dst == nodeId && connection.param == param) {
+  for (const auto &route : node.step->params) {
+    if (route.param == param) {
       return true;
     }
   }
   return false;
 }
 
-bool Engine::canSkipSilentGainUnlocked(Node &node) {
+bool Engine::canSkipSilentGain(Node &node) {
   if (!node.allowSilentInputSkip || node.kind != NodeKind::Gain ||
-      hasParamInputUnlocked(node.id, "gain")) {
+      hasParamInput(node, kGainGain)) {
     return false;
   }
-  auto it = node.timelines.find("gain");
-  if (it == node.timelines.end() || !it->second) {
-    return std::abs(currentParam(node, "gain", 1.0f)) <= 1.0e-7f;
+  auto *timeline = timelineFor(node, kGainGain);
+  return timeline && timeline->holdsValueForBlock(0.0f, renderBlockStartTime,
+                                                  getSampleRate(),
+                                                  renderFrames);
+}
+
+// Control-thread changes to render state are queued here and applied by the
+// render thread at the start of its next block. While no live stream is
+// running the control thread applies them itself, guarded against an offline
+// render() by the renderInFlight/controlApplying handshake.
+void Engine::postCommandUnlocked(std::function<void()> command) {
+  collectRetiredNodesUnlocked();
+  auto *slot = commands.beginWrite();
+  while (!slot) {
+    if (!applyCommandsFromControlUnlocked()) {
+      std::this_thread::yield();
+    }
+    slot = commands.beginWrite();
   }
-  return it->second->holdsValueForBlock(0.0f, renderBlockStartTime,
-                                        getSampleRate(), renderFrames);
+  *slot = std::move(command);
+  commands.commitWrite();
+  ++postedCommands;
+  applyCommandsFromControlUnlocked();
 }
 
-Engine::AudioBus &Engine::renderNode(int32_t nodeId,
-                                     std::vector<int32_t> &stack) {
-  auto *node = findNodeUnlocked(nodeId);
-  if (!node) {
-    return nodes[0].current;
+bool Engine::applyCommandsFromControlUnlocked() {
+  if (state.load(std::memory_order_acquire) == 1) {
+    return false;
+  }
+  controlApplying.store(true, std::memory_order_seq_cst);
+  if (renderInFlight.load(std::memory_order_seq_cst)) {
+    controlApplying.store(false, std::memory_order_seq_cst);
+    return false;
+  }
+  applyPendingCommands();
+  controlApplying.store(false, std::memory_order_seq_cst);
+  return true;
+}
+
+void Engine::waitForCommandsUnlocked() {
+  while (appliedCommands.load(std::memory_order_acquire) < postedCommands) {
+    if (!applyCommandsFromControlUnlocked()) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void Engine::applyPendingCommands() {
+  while (auto *command = commands.front()) {
+    (*command)();
+    commands.pop();
+    appliedCommands.fetch_add(1, std::memory_order_release);
+  }
+}
+
+// A removed node stays alive until the render thread has installed a plan
+// that no longer references it.
+void Engine::retireNodeUnlocked(std::unique_ptr<Node> node) {
+  retiredNodes.emplace_back(0, std::move(node));
+}
+
+void Engine::collectRetiredNodesUnlocked() {
+  const uint64_t applied = appliedCommands.load(std::memory_order_acquire);
+  retiredNodes.erase(
+      std::remove_if(retiredNodes.begin(), retiredNodes.end(),
+                     [applied](const auto &retired) {
+                       return retired.first != 0 && retired.first <= applied;
+                     }),
+      retiredNodes.end());
+}
+
+void Engine::markRenderPlanDirtyUnlocked() {
+  renderPlanDirty = true;
+  if (renderPlanBatchDepth == 0) {
+    publishRenderPlanUnlocked();
+  }
+}
+
+void Engine::planParamInputsUnlocked(Node &node, RenderPlan &plan,
+                                     RenderStep &step,
+                                     std::vector<ParamRoute> &routes) {
+  for (const auto &edge : node.paramInputEdges) {
+    Node *src = findNodeUnlocked(edge.src);
+    if (!src) {
+      continue;
+    }
+    const bool feedback = src->planMark == 1;
+    if (feedback) {
+      plan.feedbackSources.push_back(src);
+    } else {
+      if (src->planMark == 0) {
+        planNodeUnlocked(*src, plan);
+      }
+      step.pulls.push_back(src);
+    }
+    routes.push_back({edge.param, src, feedback, edge.output});
+  }
+}
+
+// Depth-first walk from the destination in the same input order the render
+// used to recurse in. A source that is still being visited closes a cycle, so
+// that route is resolved once as a feedback read of the previous block.
+void Engine::planNodeUnlocked(Node &node, RenderPlan &plan) {
+  node.planMark = 1;
+  RenderStep step;
+  step.node = &node;
+  if (node.inputCount > 0 || node.kind == NodeKind::Destination) {
+    for (const auto &edge : node.inputEdges) {
+      Node *src = findNodeUnlocked(edge.src);
+      if (!src) {
+        continue;
+      }
+      const bool feedback = src->planMark == 1;
+      if (feedback) {
+        plan.feedbackSources.push_back(src);
+      } else {
+        if (src->planMark == 0) {
+          planNodeUnlocked(*src, plan);
+        }
+        step.pulls.push_back(src);
+      }
+      step.inputs.push_back({src, feedback, edge.output, edge.input});
+    }
+  }
+  planParamInputsUnlocked(node, plan, step, step.params);
+  if (node.kind == NodeKind::Panner && listenerNode) {
+    if (!plan.listener.node) {
+      plan.listener.node = listenerNode;
+      planParamInputsUnlocked(*listenerNode, plan, step,
+                              plan.listener.params);
+    } else {
+      for (const auto &route : plan.listener.params) {
+        if (!route.feedback) {
+          step.pulls.push_back(route.src);
+        }
+      }
+    }
+  }
+  node.planMark = 2;
+  plan.steps.push_back(std::move(step));
+}
+
+void Engine::publishRenderPlanUnlocked() {
+  auto plan = std::make_shared<RenderPlan>();
+  forEachNodeUnlocked([](Node &node) { node.planMark = 0; });
+  if (destinationNode) {
+    planNodeUnlocked(*destinationNode, *plan);
+  }
+  auto &feedbackSources = plan->feedbackSources;
+  std::sort(feedbackSources.begin(), feedbackSources.end());
+  feedbackSources.erase(
+      std::unique(feedbackSources.begin(), feedbackSources.end()),
+      feedbackSources.end());
+
+  // Dependencies for the parallel renderer. Panners also evaluate the shared
+  // listener timelines, so they are chained in plan order.
+  std::unordered_map<const Node *, uint32_t> stepIndex;
+  for (size_t i = 0; i < plan->steps.size(); ++i) {
+    stepIndex.emplace(plan->steps[i].node, static_cast<uint32_t>(i));
+  }
+  std::vector<uint32_t> upstream;
+  int previousPanner = -1;
+  for (size_t i = 0; i < plan->steps.size(); ++i) {
+    auto &step = plan->steps[i];
+    upstream.clear();
+    for (auto *src : step.pulls) {
+      auto it = stepIndex.find(src);
+      if (it != stepIndex.end()) {
+        upstream.push_back(it->second);
+      }
+    }
+    if (step.node->kind == NodeKind::Panner) {
+      if (previousPanner >= 0) {
+        upstream.push_back(static_cast<uint32_t>(previousPanner));
+      }
+      previousPanner = static_cast<int>(i);
+    }
+    std::sort(upstream.begin(), upstream.end());
+    upstream.erase(std::unique(upstream.begin(), upstream.end()),
+                   upstream.end());
+    step.dependencyCount = static_cast<int>(upstream.size());
+    for (auto index : upstream) {
+      plan->steps[index].dependents.push_back(static_cast<uint32_t>(i));
+    }
+  }
+  plan->pending = std::vector<std::atomic<int>>(plan->steps.size());
+  plan->ready = std::vector<std::atomic<int>>(plan->steps.size());
+  forEachNodeUnlocked([this, &plan](Node &node) {
+    if (node.planMark == 0 && &node != listenerNode) {
+      plan->detached.push_back(&node);
+    }
+  });
+  renderPlanDirty = false;
+  postCommandUnlocked([this, plan] { installRenderPlan(*plan); });
+  for (auto &retired : retiredNodes) {
+    if (retired.first == 0) {
+      retired.first = postedCommands;
+    }
+  }
+}
+
+void Engine::installRenderPlan(RenderPlan &plan) {
+  std::swap(renderPlan, plan);
+  for (auto &step : renderPlan.steps) {
+    step.node->step = &step;
+  }
+  if (listenerNode) {
+    listenerNode->step = &renderPlan.listener;
+  }
+  for (auto *node : renderPlan.detached) {
+    // Detached nodes stop rendering; drop stale audio so a later reconnect
+    // does not surface it through a feedback route.
+    node->step = nullptr;
+    node->alias = nullptr;
+    node->current.clear();
+    node->current.silent = true;
+    node->previous.clear();
+    node->previous.silent = true;
+  }
+  // Only cycle sources keep `previous` up to date. The output of the block
+  // that just finished is still in place, so seed sources that are new to
+  // this plan from it.
+  for (auto *node : renderPlan.feedbackSources) {
+    node->previous = node->output();
+  }
+}
+
+// Walks the plan from the destination back to the sources and marks the nodes
+// the current block actually needs. Skipped nodes do not pull their inputs, so
+// branches that only feed a silent or inactive node stay idle.
+void Engine::demandRenderPlan() {
+  for (auto &step : renderPlan.steps) {
+    step.node->renderSerial = 0;
+    step.node->renderSkipped = false;
+  }
+  if (renderPlan.steps.empty()) {
+    return;
+  }
+  renderPlan.steps.back().node->renderSerial = renderSerial;
+  for (auto it = renderPlan.steps.rbegin(); it != renderPlan.steps.rend();
+       ++it) {
+    Node &node = *it->node;
+    if (node.renderSerial != renderSerial) {
+      continue;
+    }
+    if (canSkipInactiveMachineNode(node) || canSkipSilentGain(node)) {
+      node.renderSkipped = true;
+      continue;
+    }
+    for (auto *src : it->pulls) {
+      src->renderSerial = renderSerial;
+    }
+  }
+}
+
+// Kernels that transform their summed input in place: their inputs are summed
+// straight into `current` instead of going through the input scratch bus.
+static bool rendersInPlace(Engine::NodeKind kind) {
+  switch (kind) {
+  case Engine::NodeKind::Destination:
+  case Engine::NodeKind::ChannelSplitter:
+  case Engine::NodeKind::ChannelMerger:
+  case Engine::NodeKind::MediaStreamDestination:
+  case Engine::NodeKind::Analyser:
+  case Engine::NodeKind::Gain:
+  case Engine::NodeKind::BiquadFilter:
+  case Engine::NodeKind::Compressor:
+  case Engine::NodeKind::WaveShaper:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// A pass-through node fed by exactly one plain route can expose the upstream
+// bus as its output instead of copying it.
+const Engine::AudioBus *Engine::passThroughInput(const Node &node) const {
+  switch (node.kind) {
+  case NodeKind::Destination:
+  case NodeKind::ChannelSplitter:
+  case NodeKind::MediaStreamDestination:
+  case NodeKind::Analyser:
+    break;
+  default:
+    return nullptr;
+  }
+  if (!node.step || node.step->inputs.size() != 1) {
+    return nullptr;
   }
-  if (node->renderSerial == renderSerial) {
-    return node->current;
+  const auto &route = node.step->inputs.front();
+  if (route.feedback || route.output != 0 || route.input != 0) {
+    return nullptr;
   }
-  node->renderSerial = renderSerial;
-  node->current.resize(renderChannels, renderFrames);
-  node->current.clear();
-  if (canSkipInactiveMachineNodeUnlocked(*node) ||
-      canSkipSilentGainUnlocked(*node)) {
-    return node->current;
+  const AudioBus &bus = route.src->output();
+  if (bus.channels != renderChannels || bus.frames != renderFrames) {
+    return nullptr;
   }
+  return &bus;
+}
 
-  stack.push_back(nodeId);
-  AudioBus input;
-  if (node->inputCount > 0 || node->kind == NodeKind::Destination) {
-    sumInputs(*node, stack, input);
+bool Engine::inputsSilent(const Node &node) const {
+  if (!node.step) {
+    return true;
+  }
+  for (const auto &route : node.step->inputs) {
+    const AudioBus &bus =
+        route.feedback ? route.src->previous : route.src->output();
+    if (!bus.silent) {
+      return false;
+    }
   }
-  processNode(*node, input, stack);
-  stack.pop_back();
-  return node->current;
+  return true;
 }
 
-void Engine::processNode(Node &node, const AudioBus &input,
-                         std::vector<int32_t> &stack) {
+// Sources that cannot produce a sample in this quantum. Skipping them leaves
+// their state untouched, exactly as the per-sample schedule checks would.
+bool Engine::sourceIsIdle(const Node &node) const {
+  const double sr = getSampleRate();
+  const double blockStart = renderBlockStartTime;
+  const double blockEnd = blockStart + renderFrames / sr;
+  switch (node.kind) {
+  case NodeKind::Oscillator:
+  case NodeKind::ConstantSource:
+    return node.startTime < 0.0 || blockEnd <= node.startTime ||
+           blockStart >= node.stopTime;
+  case NodeKind::BufferSource: {
+    const auto &source = *node.source;
+    return source.sourceBuffer.empty() || source.sourceStartTime < 0.0 ||
+           blockEnd <= source.sourceStartTime ||
+           blockStart >= source.sourceStopTime ||
+           (source.sourceHasDuration &&
+            blockStart >= source.sourceStartTime + source.sourceDuration) ||
+           (!source.sourceLoop && source.sourceCursor >= source.sourceFrames);
+  }
+  case NodeKind::MediaStreamSource:
+    return realtimeInput.frames <= renderOffset || realtimeInput.channels <= 0;
+  default:
+    return false;
+  }
+}
+
+// Decides whether a node whose inputs are all silent can skip its kernel and
+// output silence. Linear nodes always can; stateful nodes only once their
+// tail has run out, which is tracked here.
+bool Engine::idleOnSilentInput(Node &node) {
+  switch (node.kind) {
+  case NodeKind::Destination:
+  case NodeKind::ChannelSplitter:
+  case NodeKind::ChannelMerger:
+  case NodeKind::MediaStreamDestination:
+  case NodeKind::Gain:
+  case NodeKind::StereoPanner:
+  case NodeKind::Panner:
+    return true;
+  case NodeKind::WaveShaper:
+    return node.shaper->waveShaperZeroAtRest;
+  case NodeKind::Compressor: {
+    auto &comp = *node.compressor;
+    // Lookahead still holds input that has to come out first.
+    for (const auto &line : comp.compressorLookaheadLines) {
+      if (wajuce::vec::peak(line.data(), static_cast<int>(line.size())) >
+          kTailFloor) {
+        return false;
+      }
+    }
+    // Silent input sits below any threshold, so the envelope only releases.
+    const float release =
+        std::max(0.0001f, currentParam(node, kCompressorRelease, 0.25f));
+    comp.compressorEnvelope *= static_cast<float>(std::exp(
+        -static_cast<double>(renderFrames) / (release * getSampleRate())));
+    comp.compressorReduction.store(comp.compressorEnvelope,
+                                   std::memory_order_relaxed);
+    return true;
+  }
+  case NodeKind::BiquadFilter: {
+    auto &biquad = node.filter->biquad;
+    for (auto &state : biquad) {
+      if (std::abs(state.x1) > kTailFloor || std::abs(state.x2) > kTailFloor ||
+          std::abs(state.y1) > kTailFloor || std::abs(state.y2) > kTailFloor) {
+        return false;
+      }
+    }
+    std::fill(biquad.begin(), biquad.end(), BiquadState{});
+    return true;
+  }
+  case NodeKind::IIRFilter: {
+    auto &iir = *node.iir;
+    for (auto *histories : {&iir.iirInputHistory, &iir.iirOutputHistory}) {
+      for (const auto &history : *histories) {
+        if (wajuce::vec::peak(history.data(),
+                              static_cast<int>(history.size())) > kTailFloor) {
+          return false;
+        }
+      }
+    }
+    for (auto *histories : {&iir.iirInputHistory, &iir.iirOutputHistory}) {
+      for (auto &history : *histories) {
+        std::fill(history.begin(), history.end(), 0.0f);
+      }
+    }
+    return true;
+  }
+  case NodeKind::Delay: {
+    // Without feedback the tail is one pass through the delay line. The
+    // quantum that last recirculated still counts toward the frames, so wait
+    // one more before trusting the line to be clear.
+    if (currentParam(node, kDelayFeedback, 0.0f) != 0.0f ||
+        hasParamInput(node, kDelayFeedback)) {
+      node.silentInputFrames = 0;
+      return false;
+    }
+    const auto &lines = node.delay->delayLines;
+    const size_t lineFrames = lines.empty() ? 0 : lines.front().size();
+    return node.silentInputFrames >=
+           static_cast<int64_t>(lineFrames) + kRenderQuantumFrames;
+  }
+  case NodeKind::Convolver:
+    // The partitioned convolver also holds up to two blocks of input in its
+    // frame buffers; they must be flushed before it can be skipped.
+    return node.convolver->convolverFadeFrames <= 0 &&
+           !node.convolver->convolverPendingReady &&
+           node.silentInputFrames >=
+               node.convolver->convolverFrames + 2 * ConvolverKernel::kBlock;
+  default:
+    return false;
+  }
+}
+
+// A skipped kernel does not read its params, but their timelines still have
+// to follow the clock: setTarget decays from the previous value, and
+// paramGet and the idle checks read the published one.
+void Engine::advanceParams(Node &node) {
+  const double sr = getSampleRate();
+  for (auto &slot : node.params) {
+    auto *timeline = slot.timeline.get();
+    if (!timeline) {
+      continue;
+    }
+    if (timeline->isKRate()) {
+      timeline->processBlock(renderBlockStartTime, sr / renderFrames, 1);
+    } else {
+      timeline->processBlock(renderBlockStartTime, sr, renderFrames);
+    }
+  }
+}
+
+void Engine::renderStep(RenderStep &step) {
+  Node &node = *step.node;
+  node.alias = nullptr;
+  node.current.resize(renderChannels, renderFrames);
+  if (!node.current.silent) {
+    node.current.clear();
+    node.current.silent = true;
+  }
+  if (node.renderSerial != renderSerial || node.renderSkipped) {
+    advanceParams(node);
+    return;
+  }
+  if (node.inputCount == 0 && node.kind != NodeKind::Destination) {
+    if (sourceIsIdle(node)) {
+      advanceParams(node);
+      return;
+    }
+    node.input.resize(renderChannels, 0);
+    node.current.silent = false;
+    processNode(node, node.input);
+    return;
+  }
+  const bool silentInput = inputsSilent(node);
+  if (silentInput && idleOnSilentInput(node)) {
+    advanceParams(node);
+    return;
+  }
+  node.silentInputFrames = silentInput ? node.silentInputFrames + renderFrames
+                                       : 0;
+  if (const AudioBus *bus = passThroughInput(node)) {
+    node.alias = bus;
+    processNode(node, *bus);
+    return;
+  }
+  AudioBus &input = rendersInPlace(node.kind) ? node.current : node.input;
+  sumInputs(node, input);
+  node.current.silent = false;
+  processNode(node, input);
+}
+
+// Renders the plan across the worker pool. Every step runs exactly as in the
+// serial loop and sums its inputs in route order, so the output is identical;
+// only the thread that runs a step changes.
+void Engine::renderStepsParallel() {
+  const size_t count = renderPlan.steps.size();
+  for (size_t i = 0; i < count; ++i) {
+    renderPlan.pending[i].store(renderPlan.steps[i].dependencyCount,
+                                std::memory_order_relaxed);
+    renderPlan.ready[i].store(-1, std::memory_order_relaxed);
+  }
+  readyHead.store(0, std::memory_order_relaxed);
+  readyTail.store(0, std::memory_order_relaxed);
+  renderTasksRemaining.store(static_cast<int>(count),
+                             std::memory_order_relaxed);
+  for (size_t i = 0; i < count; ++i) {
+    if (renderPlan.steps[i].dependencyCount == 0) {
+      pushReadyStep(static_cast<int>(i));
+    }
+  }
+
+  renderTasksOpen.store(true, std::memory_order_seq_cst);
+  renderWorkerGeneration.fetch_add(1, std::memory_order_release);
+  renderWorkerWake.notify_all();
+  runRenderTasks();
+  renderTasksOpen.store(false, std::memory_order_seq_cst);
+  // Workers that joined this quantum may still be leaving runRenderTasks();
+  // the plan arrays are reset at the start of the next quantum.
+  while (renderTasksActive.load(std::memory_order_seq_cst) > 0) {
+    std::this_thread::yield();
+  }
+}
+
+// Pulls ready steps until the quantum is done. A thread keeps the first
+// dependent its step released and only queues the rest, so a chain such as a
+// voice's oscillator -> filter -> gain tends to stay on one core.
+void Engine::runRenderTasks() {
+  int index = -1;
+  while (renderTasksRemaining.load(std::memory_order_acquire) > 0) {
+    if (index < 0) {
+      index = popReadyStep();
+      if (index < 0) {
+        continue;
+      }
+    }
+    auto &step = renderPlan.steps[static_cast<size_t>(index)];
+    renderStep(step);
+    int next = -1;
+    for (auto dependent : step.dependents) {
+      if (renderPlan.pending[dependent].fetch_sub(
+              1, std::memory_order_acq_rel) == 1) {
+        if (next < 0) {
+          next = static_cast<int>(dependent);
+        } else {
+          pushReadyStep(static_cast<int>(dependent));
+        }
+      }
+    }
+    renderTasksRemaining.fetch_sub(1, std::memory_order_acq_rel);
+    index = next;
+  }
+}
+
+// Each step is queued at most once per quantum, so the ready queue is a plain
+// array: a producer claims a slot and publishes the index into it, and
+// consumers advance the head only past published slots.
+void Engine::pushReadyStep(int index) {
+  const size_t slot = readyTail.fetch_add(1, std::memory_order_relaxed);
+  renderPlan.ready[slot].store(index, std::memory_order_release);
+}
+
+int Engine::popReadyStep() {
+  size_t head = readyHead.load(std::memory_order_acquire);
+  while (head < readyTail.load(std::memory_order_acquire)) {
+    const int index = renderPlan.ready[head].load(std::memory_order_acquire);
+    if (index < 0) {
+      return -1;
+    }
+    if (readyHead.compare_exchange_weak(head, head + 1,
+                                        std::memory_order_acq_rel)) {
+      return index;
+    }
+  }
+  return -1;
+}
+
+void Engine::renderWorkerMain() {
+  constexpr int kSpinsBeforeSleep = 4096;
+  uint64_t seen = renderWorkerGeneration.load(std::memory_order_acquire);
+  while (true) {
+    int spins = 0;
+    while (!renderWorkersExit.load(std::memory_order_acquire) &&
+           renderWorkerGeneration.load(std::memory_order_acquire) == seen) {
+      if (++spins < kSpinsBeforeSleep) {
+        std::this_thread::yield();
+        continue;
+      }
+      // A wake-up lost to the unlocked notify only costs this worker one
+      // quantum; the render thread finishes the work on its own.
+      std::unique_lock<std::mutex> lock(renderWorkerMtx);
+      renderWorkerWake.wait(lock, [this, seen] {
+        return renderWorkersExit.load(std::memory_order_acquire) ||
+               renderWorkerGeneration.load(std::memory_order_acquire) != seen;
+      });
+    }
+    if (renderWorkersExit.load(std::memory_order_acquire)) {
+      return;
+    }
+    seen = renderWorkerGeneration.load(std::memory_order_acquire);
+    renderTasksActive.fetch_add(1, std::memory_order_seq_cst);
+    if (renderTasksOpen.load(std::memory_order_seq_cst)) {
+      runRenderTasks();
+    }
+    renderTasksActive.fetch_sub(1, std::memory_order_seq_cst);
+  }
+}
+
+void Engine::processNode(Node &node, const AudioBus &input) {
   switch (node.kind) {
   case NodeKind::Listener:
     node.current.resize(renderChannels, renderFrames);
@@ -1215,51 +2482,67 @@ void Engine::processNode(Node &node, const AudioBus &input,
   case NodeKind::ChannelSplitter:
   case NodeKind::ChannelMerger:
   case NodeKind::MediaStreamDestination:
-    node.current = input;
     break;
-  case NodeKind::Gain:
-    node.current = input;
-    paramBlock(node, "gain", 1.0f, renderBlockStartTime, renderFrames,
-               stack, scratchParam);
-    for (int ch = 0; ch < node.current.channels; ++ch) {
-      float *out = node.current.channel(ch);
-      for (int i = 0; i < renderFrames; ++i) {
-        out[i] *= scratchParam[static_cast<size_t>(i)];
+  case NodeKind::Gain: {
+    auto &gain = node.blocks[0];
+    if (paramBlock(node, kGainGain, 1.0f, renderBlockStartTime, renderFrames,
+                   gain)) {
+      const float scalar = gain[0];
+      if (scalar == 0.0f) {
+        node.current.clear();
+        node.current.silent = true;
+      } else if (scalar != 1.0f) {
+        for (int ch = 0; ch < node.current.channels; ++ch) {
+          float *out = node.current.channel(ch);
+          wajuce::vec::scale(out, scalar, out, renderFrames);
+        }
       }
+      break;
+    }
+    if (std::all_of(gain.begin(), gain.begin() + renderFrames,
+                    [](float value) { return value == 0.0f; })) {
+      node.current.clear();
+      node.current.silent = true;
+      break;
+    }
+    for (int ch = 0; ch < node.current.channels; ++ch) {
+      wajuce::vec::multiply(gain.data(), node.current.channel(ch),
+                            renderFrames);
     }
     break;
+  }
   case NodeKind::Oscillator:
-    renderOscillator(node, stack);
+    renderOscillator(node);
     break;
   case NodeKind::ConstantSource:
-    renderConstantSource(node, stack);
+    renderConstantSource(node);
     break;
   case NodeKind::BiquadFilter:
-    renderBiquad(node, input, stack);
+    renderBiquad(node);
     break;
   case NodeKind::IIRFilter:
     renderIIRFilter(node, input);
     break;
   case NodeKind::Compressor:
-    renderCompressor(node, input, stack);
+    renderCompressor(node);
     break;
   case NodeKind::Delay:
-    renderDelay(node, input, stack);
+    renderDelay(node, input);
     break;
   case NodeKind::BufferSource:
-    renderBufferSource(node, stack);
+    renderBufferSource(node);
     break;
   case NodeKind::Analyser:
     renderAnalyser(node, input);
     break;
   case NodeKind::StereoPanner:
-    renderStereoPanner(node, input, stack);
+    renderStereoPanner(node, input);
     break;
   case NodeKind::Panner:
-    renderPanner(node, input, stack);
+    renderPanner(node, input);
     break;
   case NodeKind::WaveShaper:
-    renderWaveShaper(node, input);
+    renderWaveShaper(node);
     break;
   case NodeKind::Convolver:
     renderConvolver(node, input);
@@ -1274,173 +2557,259 @@ void Engine::processNode(Node &node, const AudioBus &input,
 }
 
 void Engine::copyCurrentToPrevious() {
-  for (auto &[_, node] : nodes) {
-    node.previous = node.current;
+  for (auto *node : renderPlan.feedbackSources) {
+    node->previous = node->output();
+  }
+}
+
+namespace {
+// The part of a quantum a scheduled source plays: frames [begin, end) are the
+// ones whose sample time t satisfies start <= t < stop. lead is how far the
+// first played frame sits past start when that frame is the first one at or
+// after start, so sources can advance their phase by the sub-sample offset.
+struct SourceSpan {
+  int begin = 0;
+  int end = 0;
+  double lead = 0.0;
+};
+} // namespace
+
+static int firstFrameAtOrAfter(double time, double blockStart, double sr,
+                               int frames) {
+  if (!(time > blockStart)) {
+    return 0;
+  }
+  const double estimate = std::ceil((time - blockStart) * sr);
+  int frame = estimate >= frames ? frames : static_cast<int>(estimate);
+  // Rounding in the estimate can land one frame off; settle it with the same
+  // comparison the per-sample checks used to make.
+  const auto timeAt = [&](int i) {
+    return blockStart + static_cast<double>(i) / sr;
+  };
+  while (frame > 0 && timeAt(frame - 1) >= time) {
+    --frame;
+  }
+  while (frame < frames && timeAt(frame) < time) {
+    ++frame;
+  }
+  return frame;
+}
+
+static SourceSpan scheduledSpan(double start, double stop, double blockStart,
+                                double sr, int frames) {
+  SourceSpan span;
+  if (start < 0.0) {
+    return span;
   }
+  span.begin = firstFrameAtOrAfter(start, blockStart, sr, frames);
+  span.end = std::max(span.begin,
+                      firstFrameAtOrAfter(stop, blockStart, sr, frames));
+  if (span.begin < span.end) {
+    const double lead =
+        blockStart + static_cast<double>(span.begin) / sr - start;
+    span.lead = lead * sr < 1.0 ? lead : 0.0;
+  }
+  return span;
 }
 
-void Engine::renderConstantSource(Node &node, std::vector<int32_t> &stack) {
+void Engine::renderConstantSource(Node &node) {
   node.current.resize(renderChannels, renderFrames);
   node.current.clear();
-  std::vector<float> offset;
-  paramBlock(node, "offset", 1.0f, renderBlockStartTime, renderFrames, stack,
+  auto &offset = node.blocks[0];
+  paramBlock(node, kConstantOffset, 1.0f, renderBlockStartTime, renderFrames,
              offset);
 
-  const double sr = getSampleRate();
-  for (int i = 0; i < renderFrames; ++i) {
-    const double t = renderBlockStartTime + static_cast<double>(i) / sr;
-    if (node.startTime < 0.0 || t < node.startTime || t >= node.stopTime) {
-      continue;
-    }
-    const float sample = offset[static_cast<size_t>(i)];
-    for (int ch = 0; ch < node.current.channels; ++ch) {
-      node.current.channel(ch)[i] = sample;
-    }
+  const SourceSpan span =
+      scheduledSpan(node.startTime, node.stopTime, renderBlockStartTime,
+                    getSampleRate(), renderFrames);
+  for (int ch = 0; ch < node.current.channels; ++ch) {
+    std::copy(offset.begin() + span.begin, offset.begin() + span.end,
+              node.current.channel(ch) + span.begin);
   }
 }
 
-void Engine::renderOscillator(Node &node, std::vector<int32_t> &stack) {
+void Engine::renderOscillator(Node &node) {
+  auto &osc = *node.oscillator;
   node.current.resize(renderChannels, renderFrames);
   node.current.clear();
-  std::vector<float> freq;
-  std::vector<float> detune;
-  paramBlock(node, "frequency", 440.0f, renderBlockStartTime, renderFrames,
-             stack, freq);
-  paramBlock(node, "detune", 0.0f, renderBlockStartTime, renderFrames, stack,
-             detune);
+  auto &freq = node.blocks[0];
+  auto &detune = node.blocks[1];
+  const bool freqConstant = paramBlock(node, kOscFrequency, 440.0f,
+                                      renderBlockStartTime, renderFrames, freq);
+  const bool detuneConstant = paramBlock(node, kOscDetune, 0.0f,
+                                        renderBlockStartTime, renderFrames,
+                                        detune);
 
   const double sr = getSampleRate();
-  for (int i = 0; i < renderFrames; ++i) {
-    const double t = renderBlockStartTime + static_cast<double>(i) / sr;
-    if (node.startTime < 0.0 || t < node.startTime || t >= node.stopTime) {
-      continue;
-    }
+  const SourceSpan span = scheduledSpan(node.startTime, node.stopTime,
+                                        renderBlockStartTime, sr, renderFrames);
+  if (span.begin >= span.end || node.current.channels == 0) {
+    return;
+  }
 
-    float sample = 0.0f;
-    switch (node.oscillatorType) {
-    case 0:
-      sample = static_cast<float>(std::sin(node.phase * 2.0 * kPi));
-      break;
-    case 1:
-      sample = node.phase < 0.5 ? 1.0f : -1.0f;
-      break;
-    case 2:
-      sample = node.phase < 0.5 ? static_cast<float>(2.0 * node.phase)
-                                : static_cast<float>(2.0 * node.phase - 2.0);
-      break;
-    case 3:
-      if (node.phase < 0.25) {
-        sample = static_cast<float>(4.0 * node.phase);
-      } else if (node.phase < 0.75) {
-        sample = static_cast<float>(2.0 - 4.0 * node.phase);
-      } else {
-        sample = static_cast<float>(4.0 * node.phase - 4.0);
-      }
-      break;
-    case 4:
-      if (!node.periodicWave.empty()) {
-        const double idx = node.phase * node.periodicWave.size();
-        const auto i0 = static_cast<size_t>(idx) % node.periodicWave.size();
-        const auto i1 = (i0 + 1) % node.periodicWave.size();
-        const float frac = static_cast<float>(idx - std::floor(idx));
-        sample = node.periodicWave[i0] +
-                 frac * (node.periodicWave[i1] - node.periodicWave[i0]);
+  const bool constantRate = freqConstant && detuneConstant;
+  const float detuneRatio =
+      detuneConstant ? std::pow(2.0f, detune[0] / 1200.0f) : 1.0f;
+  const double constantIncrement =
+      constantRate ? freq[0] * detuneRatio / sr : 0.0;
+  // Varying rates are folded into per-sample frequencies up front; the fastest
+  // one picks the wavetable level for the whole quantum.
+  double fastest = std::abs(constantIncrement);
+  if (!constantRate) {
+    float *rates = freq.data() + span.begin;
+    const int count = span.end - span.begin;
+    if (detuneConstant) {
+      wajuce::vec::scale(rates, detuneRatio, rates, count);
+    } else {
+      for (int i = 0; i < count; ++i) {
+        rates[i] *= std::pow(
+            2.0f, detune[static_cast<size_t>(span.begin + i)] / 1200.0f);
       }
-      break;
     }
-
-    for (int ch = 0; ch < node.current.channels; ++ch) {
-      node.current.channel(ch)[i] = sample;
+    for (int i = 0; i < count; ++i) {
+      fastest = std::max(fastest, std::abs(rates[i] / sr));
+    }
+  }
+  if (span.lead > 0.0) {
+    const double increment =
+        constantRate ? constantIncrement
+                     : freq[static_cast<size_t>(span.begin)] / sr;
+    osc.phase += increment * span.lead * sr;
+    osc.phase -= std::floor(osc.phase);
+  }
+
+  float *out = node.current.channel(0);
+  const auto run = [&](auto shape) {
+    double phase = osc.phase;
+    if (constantRate) {
+      for (int i = span.begin; i < span.end; ++i) {
+        out[i] = shape(phase);
+        phase += constantIncrement;
+        phase -= std::floor(phase);
+      }
+    } else {
+      for (int i = span.begin; i < span.end; ++i) {
+        out[i] = shape(phase);
+        phase += freq[static_cast<size_t>(i)] / sr;
+        phase -= std::floor(phase);
+      }
     }
+    osc.phase = phase;
+  };
+  const Wavetable *wavetable = osc.oscillatorType == 4
+                                  ? osc.periodicWave.get()
+                                  : &basicWavetable(osc.oscillatorType);
+  if (wavetable) {
+    const float *table = wavetable->levelFor(fastest);
+    run([table](double phase) { return Wavetable::lookup(table, phase); });
+  } else {
+    run([](double) { return 0.0f; });
+  }
 
-    const float actualFreq =
-        freq[static_cast<size_t>(i)] *
-        std::pow(2.0f, detune[static_cast<size_t>(i)] / 1200.0f);
-    node.phase += actualFreq / sr;
-    node.phase -= std::floor(node.phase);
+  for (int ch = 1; ch < node.current.channels; ++ch) {
+    std::copy(out + span.begin, out + span.end,
+              node.current.channel(ch) + span.begin);
   }
 }
 
-void Engine::renderBufferSource(Node &node, std::vector<int32_t> &stack) {
+void Engine::renderBufferSource(Node &node) {
+  auto &source = *node.source;
   node.current.resize(renderChannels, renderFrames);
   node.current.clear();
-  if (node.sourceBuffer.empty() || node.sourceFrames <= 0 ||
-      node.sourceChannels <= 0) {
+  if (source.sourceBuffer.empty() || source.sourceFrames <= 0 ||
+      source.sourceChannels <= 0) {
     return;
   }
 
-  std::vector<float> rateValues;
-  std::vector<float> detuneValues;
-  std::vector<float> decayValues;
-  paramBlock(node, "playbackRate", 1.0f, renderBlockStartTime, renderFrames,
-             stack, rateValues);
-  paramBlock(node, "detune", 0.0f, renderBlockStartTime, renderFrames,
-             stack, detuneValues);
-  paramBlock(node, "decay", kNeutralDecaySeconds, renderBlockStartTime,
-             renderFrames, stack, decayValues);
+  auto &rateValues = node.blocks[0];
+  auto &detuneValues = node.blocks[1];
+  auto &decayValues = node.blocks[2];
+  const bool rateConstant = paramBlock(node, kSourcePlaybackRate, 1.0f,
+                                      renderBlockStartTime, renderFrames,
+                                      rateValues);
+  const bool detuneConstant = paramBlock(node, kSourceDetune, 0.0f,
+                                        renderBlockStartTime, renderFrames,
+                                        detuneValues);
+  const bool decayConstant =
+      paramBlock(node, kSourceDecay, kNeutralDecaySeconds,
+                 renderBlockStartTime, renderFrames, decayValues);
 
   const double sr = getSampleRate();
+  const double stopTime =
+      source.sourceHasDuration
+          ? std::min(source.sourceStopTime,
+                     source.sourceStartTime + source.sourceDuration)
+          : source.sourceStopTime;
+  const SourceSpan span = scheduledSpan(source.sourceStartTime, stopTime,
+                                        renderBlockStartTime, sr, renderFrames);
+  if (span.begin >= span.end) {
+    return;
+  }
+
   const double sourceSr =
-      node.sourceSampleRate > 0 ? node.sourceSampleRate : getSampleRate();
+      source.sourceSampleRate > 0 ? source.sourceSampleRate : getSampleRate();
+  const double detuneRatio =
+      detuneConstant ? std::pow(2.0, detuneValues[0] / 1200.0) : 1.0;
+  const auto stepAt = [&](size_t i) {
+    return (sourceSr / sr) * rateValues[i] *
+           (detuneConstant ? detuneRatio
+                           : std::pow(2.0, detuneValues[i] / 1200.0));
+  };
+  const auto decayAt = [&](size_t i) {
+    const float decaySeconds = std::max(0.001f, decayValues[i]);
+    return static_cast<float>(std::exp(-1.0 / (decaySeconds * sr)));
+  };
+  const bool constantStep = rateConstant && detuneConstant;
+  const double blockStep = constantStep ? stepAt(0) : 0.0;
+  const float blockDecay = decayConstant ? decayAt(0) : 1.0f;
   int loopStartFrame =
-      static_cast<int>(std::floor(std::max(0.0, node.sourceLoopStart) * sourceSr));
-  int loopEndFrame = node.sourceLoopEnd > 0.0
-                         ? static_cast<int>(std::floor(node.sourceLoopEnd *
+      static_cast<int>(std::floor(std::max(0.0, source.sourceLoopStart) * sourceSr));
+  int loopEndFrame = source.sourceLoopEnd > 0.0
+                         ? static_cast<int>(std::floor(source.sourceLoopEnd *
                                                        sourceSr))
-                         : node.sourceFrames;
-  loopStartFrame = std::max(0, std::min(loopStartFrame, node.sourceFrames - 1));
+                         : source.sourceFrames;
+  loopStartFrame = std::max(0, std::min(loopStartFrame, source.sourceFrames - 1));
   loopEndFrame = std::max(loopStartFrame + 1,
-                          std::min(loopEndFrame, node.sourceFrames));
+                          std::min(loopEndFrame, source.sourceFrames));
+  if (span.lead > 0.0) {
+    const auto first = static_cast<size_t>(span.begin);
+    source.sourceCursor +=
+        (constantStep ? blockStep : stepAt(first)) * span.lead * sr;
+  }
 
-  for (int i = 0; i < renderFrames; ++i) {
-    const double t = renderBlockStartTime + static_cast<double>(i) / sr;
-    if (node.sourceStartTime < 0.0 || t < node.sourceStartTime ||
-        t >= node.sourceStopTime ||
-        (node.sourceHasDuration && t >= node.sourceStartTime + node.sourceDuration)) {
-      continue;
-    }
-    int frame = static_cast<int>(node.sourceCursor);
-    const int playableEnd = node.sourceLoop ? loopEndFrame : node.sourceFrames;
+  const int playableEnd = source.sourceLoop ? loopEndFrame : source.sourceFrames;
+  const double loopLen = std::max(1, loopEndFrame - loopStartFrame);
+  for (int i = span.begin; i < span.end; ++i) {
+    int frame = static_cast<int>(source.sourceCursor);
     if (frame >= playableEnd) {
-      if (!node.sourceLoop) {
-        continue;
+      if (!source.sourceLoop) {
+        // Everything after the end of a one-shot is silence, which the bus
+        // already holds.
+        break;
       }
-      const double loopLen = std::max(1, loopEndFrame - loopStartFrame);
-      node.sourceCursor =
-          loopStartFrame + std::fmod(node.sourceCursor - loopStartFrame, loopLen);
-      frame = static_cast<int>(node.sourceCursor);
+      source.sourceCursor =
+          loopStartFrame + std::fmod(source.sourceCursor - loopStartFrame, loopLen);
+      frame = static_cast<int>(source.sourceCursor);
     }
-    const int nextFrame = node.sourceLoop
+    const int nextFrame = source.sourceLoop
                               ? (frame + 1 >= loopEndFrame ? loopStartFrame
                                                            : frame + 1)
-                              : std::min(frame + 1, node.sourceFrames - 1);
-    const float frac = static_cast<float>(node.sourceCursor - frame);
+                              : std::min(frame + 1, source.sourceFrames - 1);
+    const float frac = static_cast<float>(source.sourceCursor - frame);
     for (int ch = 0; ch < node.current.channels; ++ch) {
-      const int srcCh = std::min(ch, node.sourceChannels - 1);
-      const auto base = static_cast<size_t>(srcCh * node.sourceFrames);
-      const float a = node.sourceBuffer[base + frame];
-      const float b = node.sourceBuffer[base + nextFrame];
-      node.current.channel(ch)[i] = (a + frac * (b - a)) * node.sourceEnvelope;
+      const int srcCh = std::min(ch, source.sourceChannels - 1);
+      const auto base = static_cast<size_t>(srcCh * source.sourceFrames);
+      const float a = source.sourceBuffer[base + frame];
+      const float b = source.sourceBuffer[base + nextFrame];
+      node.current.channel(ch)[i] = (a + frac * (b - a)) * source.sourceEnvelope;
     }
-    const double step =
-        (sourceSr / sr) *
-        rateValues[static_cast<size_t>(i)] *
-        std::pow(2.0, detuneValues[static_cast<size_t>(i)] / 1200.0);
-    node.sourceCursor += step;
-    const float decaySeconds =
-        std::max(0.001f, decayValues[static_cast<size_t>(i)]);
-    node.sourceEnvelope *=
-        static_cast<float>(std::exp(-1.0 / (decaySeconds * sr)));
+    const auto index = static_cast<size_t>(i);
+    source.sourceCursor += constantStep ? blockStep : stepAt(index);
+    source.sourceEnvelope *= decayConstant ? blockDecay : decayAt(index);
   }
 }
 
-struct BiquadCoefficients {
-  float b0 = 1.0f;
-  float b1 = 0.0f;
-  float b2 = 0.0f;
-  float a1 = 0.0f;
-  float a2 = 0.0f;
-};
+using BiquadCoefficients = Engine::BiquadCoefficients;
 
 static BiquadCoefficients makeBiquad(int type, float frequency, float q,
                                      float gainDb, double sr) {
@@ -1539,65 +2908,141 @@ static BiquadCoefficients makeBiquad(int type, float frequency, float q,
   return {b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0};
 }
 
-void Engine::renderBiquad(Node &node, const AudioBus &input,
-                          std::vector<int32_t> &stack) {
-  node.current = input;
-  if (node.biquad.size() < static_cast<size_t>(node.current.channels)) {
-    node.biquad.resize(static_cast<size_t>(node.current.channels));
+// Returns the filter's cached coefficients, redesigning them only when an
+// input differs from the last evaluation.
+static BiquadCoefficients cachedBiquad(Engine::FilterState &filter, int type,
+                                       float frequency, float q, float gainDb,
+                                       double sr) {
+  if (type != filter.coefficientType ||
+      frequency != filter.coefficientFrequency || q != filter.coefficientQ ||
+      gainDb != filter.coefficientGain || sr != filter.coefficientSampleRate) {
+    filter.coefficients = makeBiquad(type, frequency, q, gainDb, sr);
+    filter.coefficientType = type;
+    filter.coefficientFrequency = frequency;
+    filter.coefficientQ = q;
+    filter.coefficientGain = gainDb;
+    filter.coefficientSampleRate = sr;
+  }
+  return filter.coefficients;
+}
+
+static inline float tickBiquad(Engine::BiquadState &state,
+                               const BiquadCoefficients &c, float x) {
+  const float y = c.b0 * x + c.b1 * state.x1 + c.b2 * state.x2 -
+                  c.a1 * state.y1 - c.a2 * state.y2;
+  state.x2 = state.x1;
+  state.x1 = x;
+  state.y2 = state.y1;
+  state.y1 = y;
+  return std::isfinite(y) ? y : 0.0f;
+}
+
+void Engine::renderBiquad(Node &node) {
+  auto &filter = *node.filter;
+  if (filter.biquad.size() < static_cast<size_t>(node.current.channels)) {
+    filter.biquad.resize(static_cast<size_t>(node.current.channels));
+  }
+
+  const int filterType = filter.filterType.load(std::memory_order_relaxed);
+  auto &freqValues = node.blocks[0];
+  auto &detuneValues = node.blocks[1];
+  auto &qValues = node.blocks[2];
+  auto &gainValues = node.blocks[3];
+  const bool freqConstant =
+      paramBlock(node, kBiquadFrequency, 350.0f, renderBlockStartTime,
+                 renderFrames, freqValues);
+  const bool detuneConstant =
+      paramBlock(node, kBiquadDetune, 0.0f, renderBlockStartTime, renderFrames,
+                 detuneValues);
+  const bool qConstant = paramBlock(node, kBiquadQ, 1.0f, renderBlockStartTime,
+                                    renderFrames, qValues);
+  const bool gainConstant =
+      paramBlock(node, kBiquadGain, 0.0f, renderBlockStartTime, renderFrames,
+                 gainValues);
+
+  const double sr = getSampleRate();
+  const float detuneRatio =
+      detuneConstant ? std::pow(2.0f, detuneValues[0] / 1200.0f) : 1.0f;
+  const auto coefficientsAt = [&](int i) {
+    const auto index = static_cast<size_t>(i);
+    const float f =
+        freqValues[index] *
+        (detuneConstant ? detuneRatio
+                        : std::pow(2.0f, detuneValues[index] / 1200.0f));
+    return cachedBiquad(filter, filterType, f, qValues[index],
+                        gainValues[index], sr);
+  };
+
+  if (freqConstant && detuneConstant && qConstant && gainConstant) {
+    const BiquadCoefficients c = coefficientsAt(0);
+    for (int ch = 0; ch < node.current.channels; ++ch) {
+      auto &state = filter.biquad[static_cast<size_t>(ch)];
+      float *out = node.current.channel(ch);
+      for (int i = 0; i < renderFrames; ++i) {
+        out[i] = tickBiquad(state, c, out[i]);
+      }
+    }
+    return;
   }
 
-  std::vector<float> freqValues;
-  std::vector<float> detuneValues;
-  std::vector<float> qValues;
-  std::vector<float> gainValues;
-  paramBlock(node, "frequency", 350.0f, renderBlockStartTime, renderFrames,
-             stack, freqValues);
-  paramBlock(node, "detune", 0.0f, renderBlockStartTime, renderFrames,
-             stack, detuneValues);
-  paramBlock(node, "Q", 1.0f, renderBlockStartTime, renderFrames, stack,
-             qValues);
-  paramBlock(node, "gain", 0.0f, renderBlockStartTime, renderFrames,
-             stack, gainValues);
+  // Automated params: evaluate the design at control points and interpolate
+  // the coefficients once for all channels.
+  auto &b0 = node.blocks[4];
+  auto &b1 = node.blocks[5];
+  auto &b2 = node.blocks[6];
+  auto &a1 = node.blocks[7];
+  auto &a2 = node.blocks[8];
+  const int last = renderFrames - 1;
+  BiquadCoefficients from = coefficientsAt(0);
+  for (int start = 0; start < renderFrames; start += kBiquadControlInterval) {
+    const int end = std::min(start + kBiquadControlInterval, renderFrames);
+    const int target = std::min(end, last);
+    const BiquadCoefficients to = coefficientsAt(target);
+    const float span =
+        target > start ? 1.0f / static_cast<float>(target - start) : 0.0f;
+    for (int i = start; i < end; ++i) {
+      const auto index = static_cast<size_t>(i);
+      const float t = static_cast<float>(i - start) * span;
+      b0[index] = from.b0 + t * (to.b0 - from.b0);
+      b1[index] = from.b1 + t * (to.b1 - from.b1);
+      b2[index] = from.b2 + t * (to.b2 - from.b2);
+      a1[index] = from.a1 + t * (to.a1 - from.a1);
+      a2[index] = from.a2 + t * (to.a2 - from.a2);
+    }
+    from = to;
+  }
 
   for (int ch = 0; ch < node.current.channels; ++ch) {
-    auto &state = node.biquad[static_cast<size_t>(ch)];
+    auto &state = filter.biquad[static_cast<size_t>(ch)];
     float *out = node.current.channel(ch);
     for (int i = 0; i < renderFrames; ++i) {
-      const float f =
-          freqValues[static_cast<size_t>(i)] *
-          std::pow(2.0f, detuneValues[static_cast<size_t>(i)] / 1200.0f);
-      const auto c = makeBiquad(node.filterType, f, qValues[i], gainValues[i],
-                                getSampleRate());
-      const float x = out[i];
-      const float y = c.b0 * x + c.b1 * state.x1 + c.b2 * state.x2 -
-                      c.a1 * state.y1 - c.a2 * state.y2;
-      state.x2 = state.x1;
-      state.x1 = x;
-      state.y2 = state.y1;
-      state.y1 = y;
-      out[i] = std::isfinite(y) ? y : 0.0f;
+      const auto index = static_cast<size_t>(i);
+      out[i] = tickBiquad(
+          state, {b0[index], b1[index], b2[index], a1[index], a2[index]},
+          out[i]);
     }
   }
 }
 
 void Engine::renderIIRFilter(Node &node, const AudioBus &input) {
+  auto &iir = *node.iir;
   node.current.resize(renderChannels, renderFrames);
   node.current.clear();
-  if (node.iirFeedforward.empty() || node.iirFeedback.empty() ||
-      std::abs(node.iirFeedback[0]) < 1.0e-12) {
+  if (iir.iirFeedforward.empty() || iir.iirFeedback.empty() ||
+      std::abs(iir.iirFeedback[0]) < 1.0e-12) {
     node.current = input;
     return;
   }
 
-  const int ffLen = static_cast<int>(node.iirFeedforward.size());
-  const int fbLen = static_cast<int>(node.iirFeedback.size());
-  if (node.iirInputHistory.size() < static_cast<size_t>(renderChannels)) {
-    node.iirInputHistory.resize(static_cast<size_t>(renderChannels));
-    node.iirOutputHistory.resize(static_cast<size_t>(renderChannels));
+  const int ffLen = static_cast<int>(iir.iirFeedforward.size());
+  const int fbLen = static_cast<int>(iir.iirFeedback.size());
+  if (iir.iirInputHistory.size() < static_cast<size_t>(renderChannels)) {
+    iir.iirInputHistory.resize(static_cast<size_t>(renderChannels));
+    iir.iirOutputHistory.resize(static_cast<size_t>(renderChannels));
   }
   for (int ch = 0; ch < renderChannels; ++ch) {
-    auto &xHist = node.iirInputHistory[static_cast<size_t>(ch)];
-    auto &yHist = node.iirOutputHistory[static_cast<size_t>(ch)];
+    auto &xHist = iir.iirInputHistory[static_cast<size_t>(ch)];
+    auto &yHist = iir.iirOutputHistory[static_cast<size_t>(ch)];
     xHist.resize(static_cast<size_t>(std::max(1, ffLen)), 0.0f);
     yHist.resize(static_cast<size_t>(std::max(1, fbLen)), 0.0f);
     float *out = node.current.channel(ch);
@@ -1610,14 +3055,14 @@ void Engine::renderIIRFilter(Node &node, const AudioBus &input) {
 
       double y = 0.0;
       for (int k = 0; k < ffLen; ++k) {
-        y += node.iirFeedforward[static_cast<size_t>(k)] *
+        y += iir.iirFeedforward[static_cast<size_t>(k)] *
              xHist[static_cast<size_t>(k)];
       }
       for (int k = 1; k < fbLen; ++k) {
-        y -= node.iirFeedback[static_cast<size_t>(k)] *
+        y -= iir.iirFeedback[static_cast<size_t>(k)] *
              yHist[static_cast<size_t>(k - 1)];
       }
-      y /= node.iirFeedback[0];
+      y /= iir.iirFeedback[0];
       const float sample = std::isfinite(y) ? static_cast<float>(y) : 0.0f;
 
       for (int k = fbLen - 1; k > 1; --k) {
@@ -1632,38 +3077,51 @@ void Engine::renderIIRFilter(Node &node, const AudioBus &input) {
   }
 }
 
-void Engine::renderDelay(Node &node, const AudioBus &input,
-                         std::vector<int32_t> &stack) {
+void Engine::renderDelay(Node &node, const AudioBus &input) {
+  auto &delay = *node.delay;
   node.current.resize(renderChannels, renderFrames);
   node.current.clear();
-  if (node.delayLines.size() < static_cast<size_t>(renderChannels)) {
-    node.delayLines.resize(static_cast<size_t>(renderChannels));
+  if (delay.delayLines.size() < static_cast<size_t>(renderChannels)) {
+    delay.delayLines.resize(static_cast<size_t>(renderChannels));
   }
   const int maxDelayFrames =
-      static_cast<int>(std::ceil(node.maxDelay * getSampleRate())) +
+      static_cast<int>(std::ceil(delay.maxDelay * getSampleRate())) +
       bufferSize.load() + 8;
-  for (auto &line : node.delayLines) {
+  for (auto &line : delay.delayLines) {
     if (line.empty()) {
       line.assign(static_cast<size_t>(maxDelayFrames), 0.0f);
     }
   }
 
-  std::vector<float> delayValues;
-  std::vector<float> feedbackValues;
-  paramBlock(node, "delayTime", 0.0f, renderBlockStartTime, renderFrames,
-             stack, delayValues);
-  paramBlock(node, "feedback", 0.0f, renderBlockStartTime, renderFrames,
-             stack, feedbackValues);
+  auto &delayValues = node.blocks[0];
+  auto &feedbackValues = node.blocks[1];
+  const bool delayConstant = paramBlock(node, kDelayTime, 0.0f,
+                                       renderBlockStartTime, renderFrames,
+                                       delayValues);
+  const bool feedbackConstant = paramBlock(node, kDelayFeedback, 0.0f,
+                                          renderBlockStartTime, renderFrames,
+                                          feedbackValues);
+
+  const float sr = static_cast<float>(getSampleRate());
+  const auto delayFramesAt = [&](size_t i) {
+    return clampFloat(delayValues[i], 0.0f, delay.maxDelay) * sr;
+  };
+  const auto feedbackAt = [&](size_t i) {
+    return clampFloat(feedbackValues[i], 0.0f, 0.9995f);
+  };
+  const float blockDelayFrames = delayConstant ? delayFramesAt(0) : 0.0f;
+  const float blockFeedback = feedbackConstant ? feedbackAt(0) : 0.0f;
 
   for (int i = 0; i < renderFrames; ++i) {
+    const auto index = static_cast<size_t>(i);
+    const float delayFrames =
+        delayConstant ? blockDelayFrames : delayFramesAt(index);
+    const float fb = feedbackConstant ? blockFeedback : feedbackAt(index);
     for (int ch = 0; ch < renderChannels; ++ch) {
-      auto &line = node.delayLines[static_cast<size_t>(ch)];
+      auto &line = delay.delayLines[static_cast<size_t>(ch)];
       const int lineSize = static_cast<int>(line.size());
       const float in = ch < input.channels ? input.channel(ch)[i] : 0.0f;
-      const float delayFrames = clampFloat(delayValues[static_cast<size_t>(i)],
-                                           0.0f, node.maxDelay) *
-                                static_cast<float>(getSampleRate());
-      float readPos = static_cast<float>(node.delayWrite) - delayFrames;
+      float readPos = static_cast<float>(delay.delayWrite) - delayFrames;
       while (readPos < 0.0f) {
         readPos += static_cast<float>(lineSize);
       }
@@ -1676,95 +3134,182 @@ void Engine::renderDelay(Node &node, const AudioBus &input,
       const float delayed =
           line[static_cast<size_t>(i0)] +
           frac * (line[static_cast<size_t>(i1)] - line[static_cast<size_t>(i0)]);
-      const float fb =
-          clampFloat(feedbackValues[static_cast<size_t>(i)], 0.0f, 0.9995f);
       node.current.channel(ch)[i] = delayed;
-      line[static_cast<size_t>(node.delayWrite)] = in + delayed * fb;
-    }
-    if (!node.delayLines.empty()) {
-      node.delayWrite = (node.delayWrite + 1) %
-                        static_cast<int>(node.delayLines.front().size());
-    }
-  }
-}
-
-void Engine::renderCompressor(Node &node, const AudioBus &input,
-                              std::vector<int32_t> &stack) {
-  node.current = input;
-  std::vector<float> thresholdValues;
-  std::vector<float> kneeValues;
-  std::vector<float> ratioValues;
-  std::vector<float> attackValues;
-  std::vector<float> releaseValues;
-  paramBlock(node, "threshold", -24.0f, renderBlockStartTime, renderFrames,
-             stack, thresholdValues);
-  paramBlock(node, "knee", 30.0f, renderBlockStartTime, renderFrames, stack,
-             kneeValues);
-  paramBlock(node, "ratio", 12.0f, renderBlockStartTime, renderFrames, stack,
-             ratioValues);
-  paramBlock(node, "attack", 0.003f, renderBlockStartTime, renderFrames, stack,
-             attackValues);
-  paramBlock(node, "release", 0.25f, renderBlockStartTime, renderFrames, stack,
-             releaseValues);
+      line[static_cast<size_t>(delay.delayWrite)] = in + delayed * fb;
+    }
+    if (!delay.delayLines.empty()) {
+      delay.delayWrite = (delay.delayWrite + 1) %
+                        static_cast<int>(delay.delayLines.front().size());
+    }
+  }
+}
+
+void Engine::renderCompressor(Node &node) {
+  auto &comp = *node.compressor;
+  auto &thresholdValues = node.blocks[0];
+  auto &kneeValues = node.blocks[1];
+  auto &ratioValues = node.blocks[2];
+  auto &attackValues = node.blocks[3];
+  auto &releaseValues = node.blocks[4];
+  auto &gains = node.blocks[5];
+  const bool thresholdConstant =
+      paramBlock(node, kCompressorThreshold, -24.0f, renderBlockStartTime,
+                 renderFrames, thresholdValues);
+  const bool kneeConstant =
+      paramBlock(node, kCompressorKnee, 30.0f, renderBlockStartTime,
+                 renderFrames, kneeValues);
+  const bool ratioConstant =
+      paramBlock(node, kCompressorRatio, 12.0f, renderBlockStartTime,
+                 renderFrames, ratioValues);
+  const bool attackConstant =
+      paramBlock(node, kCompressorAttack, 0.003f, renderBlockStartTime,
+                 renderFrames, attackValues);
+  const bool releaseConstant =
+      paramBlock(node, kCompressorRelease, 0.25f, renderBlockStartTime,
+                 renderFrames, releaseValues);
+  const bool constantParams = thresholdConstant && kneeConstant &&
+                              ratioConstant && attackConstant &&
+                              releaseConstant;
+
+  const double sr = getSampleRate();
+  float threshold = 0.0f;
+  float knee = 0.0f;
+  float slope = 0.0f;
+  const auto loadParams = [&](size_t index) {
+    threshold = thresholdValues[index];
+    knee = std::max(0.0f, kneeValues[index]);
+    slope = 1.0f / std::max(1.0f, ratioValues[index]) - 1.0f;
+    const float attack = attackValues[index];
+    const float release = releaseValues[index];
+    if (attack != comp.compressorAttackTime ||
+        release != comp.compressorReleaseTime ||
+        sr != comp.compressorCoefficientRate) {
+      comp.compressorAttackTime = attack;
+      comp.compressorReleaseTime = release;
+      comp.compressorCoefficientRate = sr;
+      comp.compressorAttackCoeff = static_cast<float>(
+          std::exp(-1.0 / (std::max(0.0001f, attack) * sr)));
+      comp.compressorReleaseCoeff = static_cast<float>(
+          std::exp(-1.0 / (std::max(0.0001f, release) * sr)));
+    }
+  };
+  loadParams(0);
+
+  // Linked detector: every channel gets the gain for the loudest one, so a
+  // stereo image does not shift under compression.
+  const int channels = node.current.channels;
+  float *level = gains.data();
+  std::fill(level, level + renderFrames, 0.0f);
+  for (int ch = 0; ch < channels; ++ch) {
+    const float *in = node.current.channel(ch);
+    for (int i = 0; i < renderFrames; ++i) {
+      level[i] = std::max(level[i], std::abs(in[i]));
+    }
+  }
+
   float reduction = 0.0f;
-  for (int ch = 0; ch < node.current.channels; ++ch) {
+  float envelope = comp.compressorEnvelope;
+  for (int i = 0; i < renderFrames; ++i) {
+    const auto index = static_cast<size_t>(i);
+    if (!constantParams) {
+      loadParams(index);
+    }
+    const float db = fastGainToDecibels(std::max(level[i], kSilentFloor));
+    const float over = db - threshold;
+    float targetReduction = 0.0f;
+    if (knee > 0.0f && over > -knee * 0.5f && over < knee * 0.5f) {
+      const float x = over + knee * 0.5f;
+      targetReduction = slope * x * x / (2.0f * knee);
+    } else if (over >= knee * 0.5f) {
+      targetReduction = slope * over;
+    }
+    const float coeff = targetReduction < envelope
+                            ? comp.compressorAttackCoeff
+                            : comp.compressorReleaseCoeff;
+    envelope = coeff * envelope + (1.0f - coeff) * targetReduction;
+    level[i] = fastDecibelsToGain(envelope);
+    reduction = std::min(reduction, envelope);
+  }
+  comp.compressorEnvelope = envelope;
+
+  auto &lines = comp.compressorLookaheadLines;
+  const int delayed = std::min(channels, static_cast<int>(lines.size()));
+  for (int ch = 0; ch < delayed; ++ch) {
+    auto &line = lines[static_cast<size_t>(ch)];
+    const int length = static_cast<int>(line.size());
     float *out = node.current.channel(ch);
+    int write = comp.compressorLookaheadWrite;
     for (int i = 0; i < renderFrames; ++i) {
-      const auto index = static_cast<size_t>(i);
-      const float threshold = thresholdValues[index];
-      const float knee = std::max(0.0f, kneeValues[index]);
-      const float ratio = std::max(1.0f, ratioValues[index]);
-      const float attack = std::max(0.0001f, attackValues[index]);
-      const float release = std::max(0.0001f, releaseValues[index]);
-      const float attackCoeff =
-          static_cast<float>(std::exp(-1.0 / (attack * getSampleRate())));
-      const float releaseCoeff =
-          static_cast<float>(std::exp(-1.0 / (release * getSampleRate())));
-      const float absIn = std::max(std::abs(out[i]), kSilentFloor);
-      const float db = 20.0f * std::log10(absIn);
-      float targetReduction = 0.0f;
-      if (knee > 0.0f && db > threshold - knee * 0.5f &&
-          db < threshold + knee * 0.5f) {
-        const float x = db - threshold + knee * 0.5f;
-        targetReduction = (1.0f / ratio - 1.0f) * x * x / (2.0f * knee);
-      } else if (db >= threshold + knee * 0.5f) {
-        const float compressed = threshold + (db - threshold) / ratio;
-        targetReduction = compressed - db;
-      }
-      const float coeff =
-          targetReduction < node.compressorEnvelope ? attackCoeff : releaseCoeff;
-      node.compressorEnvelope =
-          coeff * node.compressorEnvelope + (1.0f - coeff) * targetReduction;
-      out[i] *= decibelsToGain(node.compressorEnvelope);
-      reduction = std::min(reduction, node.compressorEnvelope);
+      const float sample = line[static_cast<size_t>(write)];
+      line[static_cast<size_t>(write)] = out[i];
+      out[i] = sample;
+      write = write + 1 == length ? 0 : write + 1;
     }
   }
-  node.compressorReduction = reduction;
+  if (!lines.empty()) {
+    comp.compressorLookaheadWrite =
+        (comp.compressorLookaheadWrite + renderFrames) %
+        static_cast<int>(lines.front().size());
+  }
+
+  for (int ch = 0; ch < channels; ++ch) {
+    wajuce::vec::multiply(gains.data(), node.current.channel(ch),
+                          renderFrames);
+  }
+  comp.compressorReduction.store(reduction, std::memory_order_relaxed);
 }
 
-void Engine::renderStereoPanner(Node &node, const AudioBus &input,
-                                std::vector<int32_t> &stack) {
+// Both panners read (L + R) / 2 for a stereo or wider input.
+static void downmixToMono(const Engine::AudioBus &input, float *mono,
+                          int frames) {
+  if (input.channels > 1) {
+    wajuce::vec::scale(input.channel(0), 0.5f, mono, frames);
+    wajuce::vec::multiplyAdd(input.channel(1), 0.5f, mono, frames);
+  } else if (input.channels > 0) {
+    std::copy(input.channel(0), input.channel(0) + frames, mono);
+  } else {
+    std::fill(mono, mono + frames, 0.0f);
+  }
+}
+
+void Engine::renderStereoPanner(Node &node, const AudioBus &input) {
   node.current.resize(renderChannels, renderFrames);
   node.current.clear();
-  std::vector<float> panValues;
-  paramBlock(node, "pan", 0.0f, renderBlockStartTime, renderFrames, stack,
-             panValues);
+  auto &panValues = node.blocks[0];
+  const bool panConstant =
+      paramBlock(node, kStereoPannerPan, 0.0f, renderBlockStartTime,
+                 renderFrames, panValues);
+  float *mono = node.current.channel(0);
+  downmixToMono(input, mono, renderFrames);
+  if (renderChannels == 1) {
+    return;
+  }
+  for (int ch = 2; ch < std::min(renderChannels, input.channels); ++ch) {
+    std::copy(input.channel(ch), input.channel(ch) + renderFrames,
+              node.current.channel(ch));
+  }
+
+  wajuce::vec::clamp(panValues.data(), -1.0f, 1.0f,
+                     panConstant ? 1 : renderFrames);
+  float left = 0.0f;
+  float right = 0.0f;
+  const auto loadGains = [&](size_t index) {
+    const float angle =
+        (panValues[index] + 1.0f) * static_cast<float>(kPi * 0.25);
+    left = std::cos(angle);
+    right = std::sin(angle);
+  };
+  loadGains(0);
+  float *rightOut = node.current.channel(1);
+  if (panConstant) {
+    wajuce::vec::scale(mono, right, rightOut, renderFrames);
+    wajuce::vec::scale(mono, left, mono, renderFrames);
+    return;
+  }
   for (int i = 0; i < renderFrames; ++i) {
-    const float mono = input.channels > 1
-                           ? 0.5f * (input.channel(0)[i] + input.channel(1)[i])
-                           : (input.channels > 0 ? input.channel(0)[i] : 0.0f);
-    const float pan = clampFloat(panValues[static_cast<size_t>(i)], -1.0f, 1.0f);
-    const float angle = (pan + 1.0f) * static_cast<float>(kPi * 0.25);
-    if (renderChannels == 1) {
-      node.current.channel(0)[i] = mono;
-    } else {
-      node.current.channel(0)[i] = mono * std::cos(angle);
-      node.current.channel(1)[i] = mono * std::sin(angle);
-      for (int ch = 2; ch < renderChannels; ++ch) {
-        node.current.channel(ch)[i] =
-            ch < input.channels ? input.channel(ch)[i] : 0.0f;
-      }
-    }
+    loadGains(static_cast<size_t>(i));
+    rightOut[i] = mono[i] * right;
+    mono[i] *= left;
   }
 }
 
@@ -1816,8 +3361,8 @@ static float coneGain(float orientX, float orientY, float orientZ, float toX,
   return 1.0f + x * (outerGain - 1.0f);
 }
 
-void Engine::renderPanner(Node &node, const AudioBus &input,
-                          std::vector<int32_t> &stack) {
+void Engine::renderPanner(Node &node, const AudioBus &input) {
+  auto &panner = *node.panner;
   node.current.resize(renderChannels, renderFrames);
   node.current.clear();
   if (renderChannels == 1) {
@@ -1825,41 +3370,54 @@ void Engine::renderPanner(Node &node, const AudioBus &input,
     return;
   }
 
-  Node *listener = findNodeUnlocked(listenerNodeId);
-  std::vector<float> posX, posY, posZ, oriX, oriY, oriZ;
-  std::vector<float> lisX, lisY, lisZ;
-  paramBlock(node, "positionX", 0.0f, renderBlockStartTime, renderFrames,
-             stack, posX);
-  paramBlock(node, "positionY", 0.0f, renderBlockStartTime, renderFrames,
-             stack, posY);
-  paramBlock(node, "positionZ", 0.0f, renderBlockStartTime, renderFrames,
-             stack, posZ);
-  paramBlock(node, "orientationX", 1.0f, renderBlockStartTime, renderFrames,
-             stack, oriX);
-  paramBlock(node, "orientationY", 0.0f, renderBlockStartTime, renderFrames,
-             stack, oriY);
-  paramBlock(node, "orientationZ", 0.0f, renderBlockStartTime, renderFrames,
-             stack, oriZ);
+  Node *listener = listenerNode;
+  auto &posX = node.blocks[0];
+  auto &posY = node.blocks[1];
+  auto &posZ = node.blocks[2];
+  auto &oriX = node.blocks[3];
+  auto &oriY = node.blocks[4];
+  auto &oriZ = node.blocks[5];
+  auto &lisX = node.blocks[6];
+  auto &lisY = node.blocks[7];
+  auto &lisZ = node.blocks[8];
+  // Geometry params only move the panning gains; a block whose params are
+  // all constant computes them once.
+  bool constant = true;
+  constant &= paramBlock(node, kPannerPositionX, 0.0f, renderBlockStartTime,
+                         renderFrames, posX);
+  constant &= paramBlock(node, kPannerPositionY, 0.0f, renderBlockStartTime,
+                         renderFrames, posY);
+  constant &= paramBlock(node, kPannerPositionZ, 0.0f, renderBlockStartTime,
+                         renderFrames, posZ);
+  constant &= paramBlock(node, kPannerOrientationX, 1.0f, renderBlockStartTime,
+                         renderFrames, oriX);
+  constant &= paramBlock(node, kPannerOrientationY, 0.0f, renderBlockStartTime,
+                         renderFrames, oriY);
+  constant &= paramBlock(node, kPannerOrientationZ, 0.0f, renderBlockStartTime,
+                         renderFrames, oriZ);
   if (listener) {
-    paramBlock(*listener, "positionX", 0.0f, renderBlockStartTime, renderFrames,
-               stack, lisX);
-    paramBlock(*listener, "positionY", 0.0f, renderBlockStartTime, renderFrames,
-               stack, lisY);
-    paramBlock(*listener, "positionZ", 0.0f, renderBlockStartTime, renderFrames,
-               stack, lisZ);
+    constant &= paramBlock(*listener, kListenerPositionX, 0.0f,
+                           renderBlockStartTime, renderFrames, lisX);
+    constant &= paramBlock(*listener, kListenerPositionY, 0.0f,
+                           renderBlockStartTime, renderFrames, lisY);
+    constant &= paramBlock(*listener, kListenerPositionZ, 0.0f,
+                           renderBlockStartTime, renderFrames, lisZ);
   } else {
     lisX.assign(static_cast<size_t>(renderFrames), 0.0f);
     lisY.assign(static_cast<size_t>(renderFrames), 0.0f);
     lisZ.assign(static_cast<size_t>(renderFrames), 0.0f);
   }
 
-  for (int i = 0; i < renderFrames; ++i) {
-    const float lx = lisX[static_cast<size_t>(i)];
-    const float ly = lisY[static_cast<size_t>(i)];
-    const float lz = lisZ[static_cast<size_t>(i)];
-    const float sx = posX[static_cast<size_t>(i)];
-    const float sy = posY[static_cast<size_t>(i)];
-    const float sz = posZ[static_cast<size_t>(i)];
+  float left = 0.0f;
+  float right = 0.0f;
+  float gain = 0.0f;
+  const auto loadGains = [&](size_t i) {
+    const float lx = lisX[i];
+    const float ly = lisY[i];
+    const float lz = lisZ[i];
+    const float sx = posX[i];
+    const float sy = posY[i];
+    const float sz = posZ[i];
     const float relX = sx - lx;
     const float relY = sy - ly;
     const float relZ = sz - lz;
@@ -1871,52 +3429,50 @@ void Engine::renderPanner(Node &node, const AudioBus &input,
                                                 : 0.0f;
     const float angle = (pan + 1.0f) * static_cast<float>(kPi * 0.25);
     const float distanceGain = distanceGainForModel(
-        node.distanceModel, distance, node.refDistance, node.maxDistance,
-        node.rolloffFactor);
-    const float cone = coneGain(oriX[static_cast<size_t>(i)],
-                                oriY[static_cast<size_t>(i)],
-                                oriZ[static_cast<size_t>(i)], lx - sx, ly - sy,
-                                lz - sz, node.coneInnerAngle,
-                                node.coneOuterAngle, node.coneOuterGain);
-    const float gain = distanceGain * cone;
-    const float mono = input.channels > 1
-                           ? 0.5f * (input.channel(0)[i] + input.channel(1)[i])
-                           : (input.channels > 0 ? input.channel(0)[i] : 0.0f);
-    node.current.channel(0)[i] = mono * std::cos(angle) * gain;
-    node.current.channel(1)[i] = mono * std::sin(angle) * gain;
-    for (int ch = 2; ch < renderChannels; ++ch) {
-      node.current.channel(ch)[i] = mono * gain;
+        panner.distanceModel, distance, panner.refDistance, panner.maxDistance,
+        panner.rolloffFactor);
+    const float cone = coneGain(oriX[i], oriY[i], oriZ[i], lx - sx, ly - sy,
+                                lz - sz, panner.coneInnerAngle,
+                                panner.coneOuterAngle, panner.coneOuterGain);
+    gain = distanceGain * cone;
+    left = std::cos(angle) * gain;
+    right = std::sin(angle) * gain;
+  };
+  loadGains(0);
+
+  float *mono = node.current.channel(0);
+  downmixToMono(input, mono, renderFrames);
+  if (constant) {
+    for (int ch = 1; ch < renderChannels; ++ch) {
+      wajuce::vec::scale(mono, ch == 1 ? right : gain, node.current.channel(ch),
+                         renderFrames);
     }
+    wajuce::vec::scale(mono, left, mono, renderFrames);
+    return;
   }
-}
-
-static float shapeWithCurve(const std::vector<float> &curve, float sample) {
-  if (curve.empty()) {
-    return sample;
+  for (int i = 0; i < renderFrames; ++i) {
+    loadGains(static_cast<size_t>(i));
+    node.current.channel(1)[i] = mono[i] * right;
+    for (int ch = 2; ch < renderChannels; ++ch) {
+      node.current.channel(ch)[i] = mono[i] * gain;
+    }
+    mono[i] *= left;
   }
-  const int len = static_cast<int>(curve.size());
-  const float x = clampFloat(sample, -1.0f, 1.0f);
-  const float idx = (x + 1.0f) * 0.5f * (len - 1);
-  const int i0 = std::max(0, std::min(len - 1, static_cast<int>(idx)));
-  const int i1 = std::min(len - 1, i0 + 1);
-  const float frac = idx - i0;
-  return curve[static_cast<size_t>(i0)] +
-         frac * (curve[static_cast<size_t>(i1)] - curve[static_cast<size_t>(i0)]);
 }
 
-void Engine::renderWaveShaper(Node &node, const AudioBus &input) {
-  node.current = input;
-  if (node.waveShaperCurve.empty()) {
+void Engine::renderWaveShaper(Node &node) {
+  auto &shaper = *node.shaper;
+  if (shaper.waveShaperCurve.empty()) {
     return;
   }
-  const int factor = node.waveShaperOversample == 1
+  const int factor = shaper.waveShaperOversample == 1
                          ? 2
-                         : (node.waveShaperOversample == 2 ? 4 : 1);
+                         : (shaper.waveShaperOversample == 2 ? 4 : 1);
   for (int ch = 0; ch < node.current.channels; ++ch) {
     float *out = node.current.channel(ch);
     for (int i = 0; i < renderFrames; ++i) {
       if (factor == 1 || i + 1 >= renderFrames) {
-        out[i] = shapeWithCurve(node.waveShaperCurve, out[i]);
+        out[i] = shapeWithCurve(shaper.waveShaperCurve, out[i]);
         continue;
       }
       const float a = out[i];
@@ -1924,7 +3480,7 @@ void Engine::renderWaveShaper(Node &node, const AudioBus &input) {
       double accum = 0.0;
       for (int sub = 0; sub < factor; ++sub) {
         const float t = static_cast<float>(sub) / factor;
-        accum += shapeWithCurve(node.waveShaperCurve, a + t * (b - a));
+        accum += shapeWithCurve(shaper.waveShaperCurve, a + t * (b - a));
       }
       out[i] = static_cast<float>(accum / factor);
     }
@@ -1932,69 +3488,105 @@ void Engine::renderWaveShaper(Node &node, const AudioBus &input) {
 }
 
 void Engine::renderConvolver(Node &node, const AudioBus &input) {
+  auto &conv = *node.convolver;
+  if (conv.convolverPendingReady && conv.convolverFadeFrames <= 0) {
+    startPendingResponse(conv);
+  }
   node.current.resize(renderChannels, renderFrames);
   node.current.clear();
-  if (node.convolverBuffer.empty() || node.convolverFrames <= 0 ||
-      node.convolverChannels <= 0) {
+  const bool fading = conv.convolverFadeFrames > 0 &&
+                      conv.convolverFading.channelCount() == renderChannels;
+  // An engine partitioned for another channel count stays silent until the
+  // control side has re-prepared it.
+  const bool ready =
+      conv.convolverKernel &&
+      conv.convolverEngine.preparedFor(conv.convolverKernel.get(),
+                                       renderChannels);
+  if ((!ready && !fading) || input.channels <= 0) {
     return;
   }
-  if (node.convolverHistory.size() < static_cast<size_t>(renderChannels)) {
-    node.convolverHistory.resize(static_cast<size_t>(renderChannels));
+  conv.convolverInputs.resize(static_cast<size_t>(renderChannels));
+  conv.convolverOutputs.resize(static_cast<size_t>(renderChannels));
+  for (int ch = 0; ch < renderChannels; ++ch) {
+    conv.convolverInputs[static_cast<size_t>(ch)] =
+        input.channel(std::min(ch, input.channels - 1));
+    conv.convolverOutputs[static_cast<size_t>(ch)] = node.current.channel(ch);
   }
-  for (auto &history : node.convolverHistory) {
-    if (static_cast<int>(history.size()) != node.convolverFrames) {
-      history.assign(static_cast<size_t>(node.convolverFrames), 0.0f);
-    }
+  if (ready) {
+    conv.convolverEngine.process(conv.convolverInputs.data(),
+                                 conv.convolverOutputs.data(), renderFrames);
   }
 
-  for (int i = 0; i < renderFrames; ++i) {
+  if (fading) {
+    auto &faded = conv.convolverFadeBus;
+    faded.resize(renderChannels, renderFrames);
     for (int ch = 0; ch < renderChannels; ++ch) {
-      auto &history = node.convolverHistory[static_cast<size_t>(ch)];
-      const int inputCh = input.channels == 1 ? 0 : std::min(ch, input.channels - 1);
-      history[static_cast<size_t>(node.convolverWrite)] =
-          input.channels > 0 ? input.channel(inputCh)[i] : 0.0f;
-
-      const int irCh = node.convolverChannels == 1
-                           ? 0
-                           : std::min(ch, node.convolverChannels - 1);
-      const auto irBase = static_cast<size_t>(irCh * node.convolverFrames);
-      double sum = 0.0;
-      int read = node.convolverWrite;
-      for (int k = 0; k < node.convolverFrames; ++k) {
-        sum += history[static_cast<size_t>(read)] *
-               node.convolverBuffer[irBase + static_cast<size_t>(k)];
-        if (--read < 0) {
-          read = node.convolverFrames - 1;
-        }
+      conv.convolverOutputs[static_cast<size_t>(ch)] = faded.channel(ch);
+    }
+    conv.convolverFading.process(conv.convolverInputs.data(),
+                                 conv.convolverOutputs.data(), renderFrames);
+    // Equal-power, since the two tails are uncorrelated.
+    const double length = std::max(1, conv.convolverFadeLength);
+    for (int i = 0; i < renderFrames; ++i) {
+      const int remaining = conv.convolverFadeFrames - i;
+      const double progress = remaining > 0 ? 1.0 - remaining / length : 1.0;
+      const auto fadeIn = static_cast<float>(std::sin(progress * kPi * 0.5));
+      const auto fadeOut = static_cast<float>(std::cos(progress * kPi * 0.5));
+      for (int ch = 0; ch < renderChannels; ++ch) {
+        float &sample = node.current.channel(ch)[i];
+        sample = sample * fadeIn + faded.channel(ch)[i] * fadeOut;
       }
-      node.current.channel(ch)[i] =
-          std::isfinite(sum) ? static_cast<float>(sum) : 0.0f;
     }
-    node.convolverWrite =
-        (node.convolverWrite + 1) % std::max(1, node.convolverFrames);
+    conv.convolverFadeFrames =
+        std::max(0, conv.convolverFadeFrames - renderFrames);
+  } else {
+    conv.convolverFadeFrames = 0;
+  }
+
+  for (int ch = 0; ch < renderChannels; ++ch) {
+    float *out = node.current.channel(ch);
+    for (int i = 0; i < renderFrames; ++i) {
+      out[i] = std::isfinite(out[i]) ? out[i] : 0.0f;
+    }
   }
 }
 
 void Engine::renderAnalyser(Node &node, const AudioBus &input) {
-  node.current = input;
-  if (node.analyserTime.empty()) {
-    node.analyserTime.assign(static_cast<size_t>(node.analyserFftSize), 0.0f);
+  auto &analyser = *node.analyser;
+  std::unique_lock<std::mutex> lock(analyser.analyserMtx, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return;
   }
-  for (int i = 0; i < renderFrames; ++i) {
-    const float sample =
-        input.channels > 0 && input.frames > i ? input.channel(0)[i] : 0.0f;
-    node.analyserTime.erase(node.analyserTime.begin());
-    node.analyserTime.push_back(sample);
+  auto &ring = analyser.analyserTime;
+  if (ring.empty()) {
+    ring.assign(static_cast<size_t>(analyser.analyserFftSize), 0.0f);
+    analyser.analyserWrite = 0;
+  }
+  const size_t size = ring.size();
+  const bool hasInput = input.channels > 0 && input.frames >= renderFrames;
+  const float *samples = hasInput ? input.channel(0) : nullptr;
+  // Only the newest size samples of the quantum can survive.
+  const size_t count = std::min(size, static_cast<size_t>(renderFrames));
+  const size_t skip = static_cast<size_t>(renderFrames) - count;
+  const size_t write = analyser.analyserWrite;
+  const size_t first = std::min(count, size - write);
+  if (samples) {
+    std::copy(samples + skip, samples + skip + first, ring.begin() + write);
+    std::copy(samples + skip + first, samples + skip + count, ring.begin());
+  } else {
+    std::fill(ring.begin() + write, ring.begin() + write + first, 0.0f);
+    std::fill(ring.begin(), ring.begin() + (count - first), 0.0f);
   }
+  analyser.analyserWrite = (write + count) % size;
 }
 
 void Engine::renderMediaStreamSource(Node &node) {
   node.current.resize(renderChannels, renderFrames);
   node.current.clear();
-  if (realtimeInput.frames <= 0 || realtimeInput.channels <= 0) {
+  if (realtimeInput.frames <= renderOffset || realtimeInput.channels <= 0) {
     return;
   }
-  const int frames = std::min(renderFrames, realtimeInput.frames);
+  const int frames = std::min(renderFrames, realtimeInput.frames - renderOffset);
   for (int ch = 0; ch < renderChannels; ++ch) {
     const int srcCh = realtimeInput.channels == 1
                           ? 0
@@ -2002,7 +3594,7 @@ void Engine::renderMediaStreamSource(Node &node) {
     const float *src = realtimeInput.channel(srcCh);
     float *dst = node.current.channel(ch);
     if (src && dst) {
-      std::copy(src, src + frames, dst);
+      std::copy(src + renderOffset, src + renderOffset + frames, dst);
       if (frames < renderFrames) {
         std::fill(dst + frames, dst + renderFrames, 0.0f);
       }
@@ -2011,45 +3603,50 @@ void Engine::renderMediaStreamSource(Node &node) {
 }
 
 void Engine::renderWorklet(Node &node, const AudioBus &input) {
+  auto &worklet = *node.worklet;
   node.current.resize(renderChannels, renderFrames);
   node.current.clear();
-  if (!node.bridge || !node.bridge->active.load(std::memory_order_acquire)) {
+  if (!worklet.bridge || !worklet.bridge->active.load(std::memory_order_acquire)) {
     return;
   }
-  if (node.workletLastOutput.size() <
-      static_cast<size_t>(node.bridge->outputChannels)) {
-    node.workletLastOutput.assign(
-        static_cast<size_t>(node.bridge->outputChannels), 0.0f);
+  if (worklet.workletLastOutput.size() <
+      static_cast<size_t>(worklet.bridge->outputChannels)) {
+    worklet.workletLastOutput.assign(
+        static_cast<size_t>(worklet.bridge->outputChannels), 0.0f);
   }
-  for (int ch = 0; ch < node.bridge->inputChannels; ++ch) {
-    if (auto *rb = node.bridge->toIsolate->getChannel(ch)) {
-      const float *src =
-          ch < input.channels ? input.channel(ch) : node.current.channel(0);
+  for (int ch = 0; ch < worklet.bridge->inputChannels; ++ch) {
+    if (auto *rb = worklet.bridge->toIsolate->getChannel(ch)) {
+      // A bridge without inputs renders from a frameless bus; feed it silence.
+      const float *src = ch < input.channels ? input.channel(ch) : nullptr;
+      if (!src) {
+        src = node.current.channel(0);
+      }
       const int written = rb->write(src, renderFrames);
       if (written < renderFrames) {
-        node.bridge->droppedInputSamples.fetch_add(renderFrames - written,
+        worklet.bridge->droppedInputSamples.fetch_add(renderFrames - written,
                                                    std::memory_order_relaxed);
       }
     }
   }
-  std::vector<float> tmp(static_cast<size_t>(renderFrames), 0.0f);
-  for (int ch = 0; ch < std::min(renderChannels, node.bridge->outputChannels);
+  auto &tmp = node.blocks[0];
+  tmp.resize(static_cast<size_t>(renderFrames));
+  for (int ch = 0; ch < std::min(renderChannels, worklet.bridge->outputChannels);
        ++ch) {
     std::fill(tmp.begin(), tmp.end(), 0.0f);
     int read = 0;
-    if (auto *rb = node.bridge->fromIsolate->getChannel(ch)) {
+    if (auto *rb = worklet.bridge->fromIsolate->getChannel(ch)) {
       read = rb->read(tmp.data(), renderFrames);
     }
-    float held = node.workletLastOutput[static_cast<size_t>(ch)];
+    float held = worklet.workletLastOutput[static_cast<size_t>(ch)];
     if (read > 0) {
       held = tmp[static_cast<size_t>(read - 1)];
     }
     if (read < renderFrames) {
       std::fill(tmp.begin() + read, tmp.end(), held);
-      node.bridge->outputUnderrunSamples.fetch_add(renderFrames - read,
+      worklet.bridge->outputUnderrunSamples.fetch_add(renderFrames - read,
                                                    std::memory_order_relaxed);
     }
-    node.workletLastOutput[static_cast<size_t>(ch)] = held;
+    worklet.workletLastOutput[static_cast<size_t>(ch)] = held;
     std::copy(tmp.begin(), tmp.end(), node.current.channel(ch));
   }
 }
@@ -2064,12 +3661,8 @@ void Engine::setRealtimeInputInterleaved(const float *input, int frames,
       channels == 1 && outputChannels.load(std::memory_order_relaxed) > 1 ? 2
                                                                           : channels;
   realtimeInput.resize(storedChannels, frames);
-  for (int i = 0; i < frames; ++i) {
-    for (int ch = 0; ch < channels; ++ch) {
-      realtimeInput.channel(ch)[i] =
-          input[static_cast<size_t>(i * channels + ch)];
-    }
-  }
+  wajuce::vec::deinterleave(input, frames, channels,
+                            realtimeInput.samples.data());
   if (channels == 1 && storedChannels > 1) {
     float *left = realtimeInput.channel(0);
     float *right = realtimeInput.channel(1);
@@ -2109,69 +3702,119 @@ int32_t Engine::render(float *outData, int32_t frames, int32_t channels) {
   if (!outData || frames <= 0 || channels <= 0) {
     return 0;
   }
-  std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  renderFrames = frames;
-  renderChannels = channels;
-  renderBlockStartTime = getCurrentTime();
-  ++renderSerial;
-
-  for (auto &[_, node] : nodes) {
-    node.current.resize(renderChannels, renderFrames);
-    node.current.clear();
+  renderInFlight.store(true, std::memory_order_seq_cst);
+  if (controlApplying.load(std::memory_order_seq_cst)) {
+    // The control thread is applying commands on a stopped context.
+    renderInFlight.store(false, std::memory_order_seq_cst);
+    std::fill(outData, outData + static_cast<size_t>(frames * channels), 0.0f);
+    return frames;
   }
+  applyPendingCommands();
+  renderChannels = channels;
+  const double blockStartTime = getCurrentTime();
+  const double sr = getSampleRate();
 
-  std::vector<int32_t> stack;
-  AudioBus &destination = renderNode(0, stack);
-  for (int ch = 0; ch < channels; ++ch) {
-    const float *src =
-        ch < destination.channels ? destination.channel(ch) : nullptr;
-    float *dst = outData + static_cast<size_t>(ch * frames);
-    if (src) {
-      std::copy(src, src + frames, dst);
+  // The caller's block is rendered as a run of fixed quanta; only a trailing
+  // remainder is shorter.
+  for (renderOffset = 0; renderOffset < frames;
+       renderOffset += renderFrames) {
+    renderFrames = std::min(kRenderQuantumFrames, frames - renderOffset);
+    renderBlockStartTime =
+        sr > 0.0 ? blockStartTime + renderOffset / sr : blockStartTime;
+    ++renderSerial;
+
+    demandRenderPlan();
+    if (renderWorkerCount.load(std::memory_order_relaxed) == 0 ||
+        renderPlan.steps.size() < 2) {
+      for (auto &step : renderPlan.steps) {
+        renderStep(step);
+      }
     } else {
-      std::fill(dst, dst + frames, 0.0f);
+      renderStepsParallel();
+    }
+    const AudioBus *destination =
+        renderPlan.steps.empty() ? nullptr
+                                 : &renderPlan.steps.back().node->output();
+    for (int ch = 0; ch < channels; ++ch) {
+      const float *src = destination && ch < destination->channels
+                             ? destination->channel(ch)
+                             : nullptr;
+      float *dst = outData + static_cast<size_t>(ch) * frames + renderOffset;
+      if (src) {
+        std::copy(src, src + renderFrames, dst);
+      } else {
+        std::fill(dst, dst + renderFrames, 0.0f);
+      }
     }
+    copyCurrentToPrevious();
   }
-  copyCurrentToPrevious();
-  const double sr = getSampleRate();
+  renderOffset = 0;
   if (sr > 0.0) {
-    currentTime.store(renderBlockStartTime + frames / sr,
-                      std::memory_order_release);
+    currentTime.store(blockStartTime + frames / sr, std::memory_order_release);
   }
+  renderInFlight.store(false, std::memory_order_seq_cst);
   return frames;
 }
 
-static void fillFrequencyData(Engine::Node &node, float *magnitudes,
-                              int32_t len, double sampleRate) {
+static void fillFrequencyData(Engine::AnalyserState &analyser,
+                              float *magnitudes, int32_t len,
+                              double sampleRate) {
   if (!magnitudes || len <= 0) {
     return;
   }
-  const auto &time = node.analyserTime;
-  const int n = static_cast<int>(time.size());
+  // analyserMtx is held only to unroll the ring oldest-first into the frame;
+  // the render thread drops its quantum whenever it finds the lock taken, so
+  // windowing and the transform run after it is released.
+  int n = 0;
+  float minDecibels = 0.0f;
+  float smoothing = 0.0f;
+  {
+    std::lock_guard<std::mutex> analyserLock(analyser.analyserMtx);
+    const auto &time = analyser.analyserTime;
+    n = static_cast<int>(time.size());
+    minDecibels = analyser.analyserMinDecibels;
+    smoothing = analyser.analyserSmoothing;
+    if (n > 0) {
+      analyser.analyserFrame.resize(static_cast<size_t>(n));
+      const auto oldest =
+          time.begin() + static_cast<std::ptrdiff_t>(analyser.analyserWrite);
+      std::copy(time.begin(), oldest,
+                std::copy(oldest, time.end(), analyser.analyserFrame.begin()));
+    }
+  }
   if (n <= 0) {
     std::fill(magnitudes, magnitudes + len, -100.0f);
     return;
   }
-  if (node.analyserPreviousDb.size() < static_cast<size_t>(len)) {
-    node.analyserPreviousDb.assign(static_cast<size_t>(len),
-                                   node.analyserMinDecibels);
+  if (analyser.analyserPreviousDb.size() < static_cast<size_t>(len)) {
+    analyser.analyserPreviousDb.assign(static_cast<size_t>(len), minDecibels);
   }
-  for (int bin = 0; bin < len; ++bin) {
-    double re = 0.0;
-    double im = 0.0;
+  if (!analyser.analyserFft || analyser.analyserFft->size() != n) {
+    analyser.analyserFft = std::make_unique<RealFFT<float>>(n);
+    analyser.analyserWindow.resize(static_cast<size_t>(n));
     for (int i = 0; i < n; ++i) {
-      const double window = 0.5 - 0.5 * std::cos((2.0 * kPi * i) / (n - 1));
-      const double phase = -2.0 * kPi * static_cast<double>(bin) * i / n;
-      re += time[static_cast<size_t>(i)] * window * std::cos(phase);
-      im += time[static_cast<size_t>(i)] * window * std::sin(phase);
+      analyser.analyserWindow[static_cast<size_t>(i)] = static_cast<float>(
+          0.5 - 0.5 * std::cos((2.0 * kPi * i) / (n - 1)));
     }
+    analyser.analyserSpectrum.resize(static_cast<size_t>(n / 2 + 1));
+  }
+  wajuce::vec::multiply(analyser.analyserWindow.data(),
+                        analyser.analyserFrame.data(), n);
+  analyser.analyserFft->forward(analyser.analyserFrame.data(),
+                                analyser.analyserSpectrum.data());
+
+  for (int bin = 0; bin < len; ++bin) {
+    // Bins past Nyquist mirror the ones below it, as a full DFT would.
+    int k = bin % n;
+    k = k > n / 2 ? n - k : k;
     const float mag =
-        static_cast<float>(std::sqrt(re * re + im * im) / std::max(1, n));
+        std::abs(analyser.analyserSpectrum[static_cast<size_t>(k)]) /
+        static_cast<float>(n);
     const float db = 20.0f * std::log10(std::max(mag, kSilentFloor));
-    const float previous = node.analyserPreviousDb[static_cast<size_t>(bin)];
-    const float smoothed =
-        node.analyserSmoothing * previous + (1.0f - node.analyserSmoothing) * db;
-    node.analyserPreviousDb[static_cast<size_t>(bin)] = smoothed;
+    const float previous =
+        analyser.analyserPreviousDb[static_cast<size_t>(bin)];
+    const float smoothed = smoothing * previous + (1.0f - smoothing) * db;
+    analyser.analyserPreviousDb[static_cast<size_t>(bin)] = smoothed;
     magnitudes[bin] = smoothed;
   }
   (void)sampleRate;
@@ -2180,11 +3823,11 @@ static void fillFrequencyData(Engine::Node &node, float *magnitudes,
 void Engine::analyserGetFloatFreqData(int32_t nodeId, float *data,
                                       int32_t len) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  auto *node = findNodeUnlocked(nodeId);
+  auto *node = findNodeUnlocked(nodeId, NodeKind::Analyser);
   if (!node || !data || len <= 0) {
     return;
   }
-  fillFrequencyData(*node, data, len, getSampleRate());
+  fillFrequencyData(*node->analyser, data, len, getSampleRate());
 }
 
 void Engine::analyserGetByteFreqData(int32_t nodeId, uint8_t *data,
@@ -2193,18 +3836,24 @@ void Engine::analyserGetByteFreqData(int32_t nodeId, uint8_t *data,
     return;
   }
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  auto *node = findNodeUnlocked(nodeId);
+  auto *node = findNodeUnlocked(nodeId, NodeKind::Analyser);
   if (!node) {
     std::fill(data, data + len, 0);
     return;
   }
+  auto &analyser = *node->analyser;
   std::vector<float> db(static_cast<size_t>(len), -100.0f);
-  fillFrequencyData(*node, db.data(), len, getSampleRate());
-  const float range =
-      std::max(0.001f, node->analyserMaxDecibels - node->analyserMinDecibels);
+  fillFrequencyData(analyser, db.data(), len, getSampleRate());
+  float minDecibels = 0.0f;
+  float maxDecibels = 0.0f;
+  {
+    std::lock_guard<std::mutex> analyserLock(analyser.analyserMtx);
+    minDecibels = analyser.analyserMinDecibels;
+    maxDecibels = analyser.analyserMaxDecibels;
+  }
+  const float range = std::max(0.001f, maxDecibels - minDecibels);
   for (int i = 0; i < len; ++i) {
-    const float normalized =
-        (db[static_cast<size_t>(i)] - node->analyserMinDecibels) / range;
+    const float normalized = (db[static_cast<size_t>(i)] - minDecibels) / range;
     data[i] = static_cast<uint8_t>(clampFloat(normalized, 0.0f, 1.0f) * 255.0f);
   }
 }
@@ -2212,17 +3861,24 @@ void Engine::analyserGetByteFreqData(int32_t nodeId, uint8_t *data,
 void Engine::analyserGetFloatTimeData(int32_t nodeId, float *data,
                                       int32_t len) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  const auto *node = findNodeUnlocked(nodeId);
-  if (!node || !data || len <= 0 || node->analyserTime.empty()) {
+  auto *node = findNodeUnlocked(nodeId, NodeKind::Analyser);
+  if (!node || !data || len <= 0) {
     if (data && len > 0) {
       std::fill(data, data + len, 0.0f);
     }
     return;
   }
+  auto &analyser = *node->analyser;
+  std::lock_guard<std::mutex> analyserLock(analyser.analyserMtx);
+  const auto &time = analyser.analyserTime;
+  if (time.empty()) {
+    std::fill(data, data + len, 0.0f);
+    return;
+  }
   for (int i = 0; i < len; ++i) {
-    const size_t idx =
-        static_cast<size_t>(i) * node->analyserTime.size() / len;
-    data[i] = node->analyserTime[std::min(idx, node->analyserTime.size() - 1)];
+    const size_t idx = std::min(static_cast<size_t>(i) * time.size() / len,
+                                time.size() - 1);
+    data[i] = time[(analyser.analyserWrite + idx) % time.size()];
   }
 }
 
@@ -2248,19 +3904,20 @@ void Engine::biquadGetFrequencyResponse(int32_t nodeId, const float *frequencyHz
     return;
   }
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  auto *node = findNodeUnlocked(nodeId);
+  auto *node = findNodeUnlocked(nodeId, NodeKind::BiquadFilter);
   if (!node) {
     std::fill(magResponse, magResponse + len, 0.0f);
     std::fill(phaseResponse, phaseResponse + len, 0.0f);
     return;
   }
-  const float baseFreq = currentParam(*node, "frequency", 350.0f);
-  const float detune = currentParam(*node, "detune", 0.0f);
-  const float q = currentParam(*node, "Q", 1.0f);
-  const float gain = currentParam(*node, "gain", 0.0f);
+  const float baseFreq = currentParam(*node, kBiquadFrequency, 350.0f);
+  const float detune = currentParam(*node, kBiquadDetune, 0.0f);
+  const float q = currentParam(*node, kBiquadQ, 1.0f);
+  const float gain = currentParam(*node, kBiquadGain, 0.0f);
   const float effectiveFreq = baseFreq * std::pow(2.0f, detune / 1200.0f);
-  const auto c = makeBiquad(node->filterType, effectiveFreq, q, gain,
-                            getSampleRate());
+  const auto c =
+      makeBiquad(node->filter->filterType.load(std::memory_order_relaxed),
+                 effectiveFreq, q, gain, getSampleRate());
   for (int i = 0; i < len; ++i) {
     const double omega = 2.0 * kPi * frequencyHz[i] / getSampleRate();
     const double c1 = std::cos(omega);
@@ -2286,8 +3943,9 @@ void Engine::iirGetFrequencyResponse(int32_t nodeId, const float *frequencyHz,
     return;
   }
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  auto *node = findNodeUnlocked(nodeId);
-  if (!node || node->iirFeedforward.empty() || node->iirFeedback.empty()) {
+  auto *node = findNodeUnlocked(nodeId, NodeKind::IIRFilter);
+  if (!node || node->iir->iirFeedforward.empty() ||
+      node->iir->iirFeedback.empty()) {
     std::fill(magResponse, magResponse + len, 0.0f);
     std::fill(phaseResponse, phaseResponse + len, 0.0f);
     return;
@@ -2298,17 +3956,17 @@ void Engine::iirGetFrequencyResponse(int32_t nodeId, const float *frequencyHz,
     const double omega = 2.0 * kPi * frequencyHz[i] / sr;
     double numRe = 0.0;
     double numIm = 0.0;
-    for (size_t k = 0; k < node->iirFeedforward.size(); ++k) {
+    for (size_t k = 0; k < node->iir->iirFeedforward.size(); ++k) {
       const double phase = -omega * static_cast<double>(k);
-      numRe += node->iirFeedforward[k] * std::cos(phase);
-      numIm += node->iirFeedforward[k] * std::sin(phase);
+      numRe += node->iir->iirFeedforward[k] * std::cos(phase);
+      numIm += node->iir->iirFeedforward[k] * std::sin(phase);
     }
     double denRe = 0.0;
     double denIm = 0.0;
-    for (size_t k = 0; k < node->iirFeedback.size(); ++k) {
+    for (size_t k = 0; k < node->iir->iirFeedback.size(); ++k) {
       const double phase = -omega * static_cast<double>(k);
-      denRe += node->iirFeedback[k] * std::cos(phase);
-      denIm += node->iirFeedback[k] * std::sin(phase);
+      denRe += node->iir->iirFeedback[k] * std::cos(phase);
+      denIm += node->iir->iirFeedback[k] * std::sin(phase);
     }
     const double denMag = denRe * denRe + denIm * denIm;
     if (denMag <= kSilentFloor) {
@@ -2325,63 +3983,113 @@ void Engine::iirGetFrequencyResponse(int32_t nodeId, const float *frequencyHz,
 
 float Engine::compressorGetReduction(int32_t nodeId) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  const auto *node = findNodeUnlocked(nodeId);
-  return node ? node->compressorReduction : 0.0f;
+  const auto *node = findNodeUnlocked(nodeId, NodeKind::Compressor);
+  return node ? node->compressor->compressorReduction.load(
+                    std::memory_order_relaxed)
+              : 0.0f;
+}
+
+void Engine::compressorSetLookahead(int32_t nodeId, double seconds) {
+  std::lock_guard<std::recursive_mutex> lock(graphMtx);
+  auto *node = findNodeUnlocked(nodeId, NodeKind::Compressor);
+  if (!node) {
+    return;
+  }
+  const double clamped =
+      std::isfinite(seconds)
+          ? std::max(0.0, std::min(kCompressorMaxLookaheadSeconds, seconds))
+          : 0.0;
+  node->compressor->compressorLookaheadFrames =
+      static_cast<size_t>(std::lround(clamped * getSampleRate()));
+  postCompressorLookaheadUnlocked(*node);
+}
+
+// Every channel the node renders gets a line, so none of them runs ahead of
+// the gain computed for it.
+void Engine::postCompressorLookaheadUnlocked(Node &node) {
+  const size_t frames = node.compressor->compressorLookaheadFrames;
+  const int channels = preparedChannelCount.load(std::memory_order_relaxed);
+  std::vector<std::vector<float>> lines;
+  if (frames > 0) {
+    lines.assign(static_cast<size_t>(channels),
+                 std::vector<float>(frames, 0.0f));
+  }
+  Node *target = &node;
+  postCommandUnlocked([target, lines = std::move(lines)]() mutable {
+    target->compressor->compressorLookaheadLines.swap(lines);
+    target->compressor->compressorLookaheadWrite = 0;
+  });
 }
 
 void Engine::pannerSetPanningModel(int32_t nodeId, int model) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->panningModel = std::max(0, std::min(1, model));
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::Panner)) {
+    const int clamped = std::max(0, std::min(1, model));
+    postCommandUnlocked(
+        [node, clamped] { node->panner->panningModel = clamped; });
   }
 }
 
 void Engine::pannerSetDistanceModel(int32_t nodeId, int model) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->distanceModel = std::max(0, std::min(2, model));
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::Panner)) {
+    const int clamped = std::max(0, std::min(2, model));
+    postCommandUnlocked(
+        [node, clamped] { node->panner->distanceModel = clamped; });
   }
 }
 
 void Engine::pannerSetRefDistance(int32_t nodeId, double value) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->refDistance = std::max(0.0f, static_cast<float>(value));
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::Panner)) {
+    const float distance = std::max(0.0f, static_cast<float>(value));
+    postCommandUnlocked(
+        [node, distance] { node->panner->refDistance = distance; });
   }
 }
 
 void Engine::pannerSetMaxDistance(int32_t nodeId, double value) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->maxDistance = std::max(node->refDistance, static_cast<float>(value));
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::Panner)) {
+    const float distance = static_cast<float>(value);
+    postCommandUnlocked([node, distance] {
+      node->panner->maxDistance = std::max(node->panner->refDistance, distance);
+    });
   }
 }
 
 void Engine::pannerSetRolloffFactor(int32_t nodeId, double value) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->rolloffFactor = std::max(0.0f, static_cast<float>(value));
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::Panner)) {
+    const float rolloff = std::max(0.0f, static_cast<float>(value));
+    postCommandUnlocked(
+        [node, rolloff] { node->panner->rolloffFactor = rolloff; });
   }
 }
 
 void Engine::pannerSetConeInnerAngle(int32_t nodeId, double value) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->coneInnerAngle = clampFloat(static_cast<float>(value), 0.0f, 360.0f);
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::Panner)) {
+    const float angle = clampFloat(static_cast<float>(value), 0.0f, 360.0f);
+    postCommandUnlocked(
+        [node, angle] { node->panner->coneInnerAngle = angle; });
   }
 }
 
 void Engine::pannerSetConeOuterAngle(int32_t nodeId, double value) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->coneOuterAngle = clampFloat(static_cast<float>(value), 0.0f, 360.0f);
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::Panner)) {
+    const float angle = clampFloat(static_cast<float>(value), 0.0f, 360.0f);
+    postCommandUnlocked(
+        [node, angle] { node->panner->coneOuterAngle = angle; });
   }
 }
 
 void Engine::pannerSetConeOuterGain(int32_t nodeId, double value) {
   std::lock_guard<std::recursive_mutex> lock(graphMtx);
-  if (auto *node = findNodeUnlocked(nodeId)) {
-    node->coneOuterGain = clampFloat(static_cast<float>(value), 0.0f, 1.0f);
+  if (auto *node = findNodeUnlocked(nodeId, NodeKind::Panner)) {
+    const float gain = clampFloat(static_cast<float>(value), 0.0f, 1.0f);
+    postCommandUnlocked([node, gain] { node->panner->coneOuterGain = gain; });
   }
 }
 
@@ -2419,6 +4127,7 @@ bool Engine::ensureRealtimeStream() {
     outParams.firstChannel = 0;
     outputChannels.store(static_cast<int>(outParams.nChannels),
                          std::memory_order_release);
+    prepareRenderChannels(static_cast<int32_t>(outParams.nChannels));
 
     RtAudio::StreamParameters inParams;
     RtAudio::StreamParameters *inPtr = nullptr;
@@ -2469,6 +4178,8 @@ bool Engine::ensureRealtimeStream() {
       return false;
     }
     bufferSize.store(static_cast<int>(frames), std::memory_order_release);
+    realtimeOutput.assign(static_cast<size_t>(outParams.nChannels) * frames,
+                          0.0f);
     realtimeOpen = true;
     const auto startErr = realtime->startStream();
     if (startErr != RTAUDIO_NO_ERROR && startErr != RTAUDIO_WARNING) {
@@ -2515,14 +4226,12 @@ int Engine::rtAudioCallback(void *outputBuffer, void *inputBuffer, unsigned int
     engine->setRealtimeInputInterleaved(static_cast<const float *>(inputBuffer),
                                         static_cast<int>(nFrames), inChannels);
   }
-  std::vector<float> planar(static_cast<size_t>(channels * nFrames), 0.0f);
+  // Reuses the buffer sized when the stream opened.
+  auto &planar = engine->realtimeOutput;
+  planar.assign(static_cast<size_t>(channels) * nFrames, 0.0f);
   engine->render(planar.data(), static_cast<int32_t>(nFrames), channels);
-  for (unsigned int i = 0; i < nFrames; ++i) {
-    for (int ch = 0; ch < channels; ++ch) {
-      out[i * channels + ch] =
-          planar[static_cast<size_t>(ch * nFrames + i)];
-    }
-  }
+  wajuce::vec::interleave(planar.data(), static_cast<int>(nFrames), channels,
+                          out);
   return 0;
 }
 #endif
@@ -2716,6 +4425,20 @@ bool Engine::ensureAppleAudioUnit() {
   AudioUnitSetProperty(appleAudioUnit, kAudioUnitProperty_MaximumFramesPerSlice,
                        kAudioUnitScope_Global, 0, &maxFrames,
                        sizeof(maxFrames));
+  // The render callback reuses these instead of allocating per slice.
+  const int maxInputChannels =
+      std::max(0, inputChannels.load(std::memory_order_relaxed));
+  appleInputList.assign(sizeof(AudioBufferList) +
+                            static_cast<size_t>(std::max(0, maxInputChannels - 1)) *
+                                sizeof(AudioBuffer),
+                        0);
+  appleInputPlanar.assign(static_cast<size_t>(maxInputChannels) * maxFrames,
+                          0.0f);
+  realtimeOutput.assign(
+      static_cast<size_t>(
+          std::max(1, outputChannels.load(std::memory_order_relaxed))) *
+          maxFrames,
+      0.0f);
 
   AURenderCallbackStruct callback{};
   callback.inputProc = &Engine::appleAudioUnitCallback;
@@ -2777,13 +4500,14 @@ OSStatus Engine::appleAudioUnitCallback(void *inRefCon,
     const size_t bufferListSize =
         sizeof(AudioBufferList) +
         static_cast<size_t>(inputChannelCount - 1) * sizeof(AudioBuffer);
-    std::vector<uint8_t> inputListStorage(bufferListSize, 0);
+    auto &inputListStorage = engine->appleInputList;
+    inputListStorage.assign(bufferListSize, 0);
     auto *inputList =
         reinterpret_cast<AudioBufferList *>(inputListStorage.data());
-    std::vector<float> inputPlanar(
-        static_cast<size_t>(inputChannelCount) *
-            static_cast<size_t>(frameCount),
-        0.0f);
+    auto &inputPlanar = engine->appleInputPlanar;
+    inputPlanar.assign(static_cast<size_t>(inputChannelCount) *
+                           static_cast<size_t>(frameCount),
+                       0.0f);
     inputList->mNumberBuffers = static_cast<UInt32>(inputChannelCount);
     for (int ch = 0; ch < inputChannelCount; ++ch) {
       inputList->mBuffers[ch].mNumberChannels = 1;
@@ -2804,7 +4528,8 @@ OSStatus Engine::appleAudioUnitCallback(void *inRefCon,
 
   const int channels =
       std::max(1, engine->outputChannels.load(std::memory_order_relaxed));
-  std::vector<float> planar(
+  auto &planar = engine->realtimeOutput;
+  planar.assign(
       static_cast<size_t>(channels) * static_cast<size_t>(frameCount), 0.0f);
   if (engine->state.load(std::memory_order_relaxed) == 1) {
     engine->render(planar.data(), static_cast<int32_t>(frameCount), channels);
@@ -2819,6 +4544,11 @@ OSStatus Engine::appleAudioUnitCallback(void *inRefCon,
     const UInt32 outChannels = ioData->mBuffers[0].mNumberChannels;
     const size_t samples =
         static_cast<size_t>(frameCount) * static_cast<size_t>(outChannels);
+    if (outChannels == static_cast<UInt32>(channels)) {
+      wajuce::vec::interleave(planar.data(), static_cast<int>(frameCount),
+                              channels, out);
+      return noErr;
+    }
     std::fill(out, out + samples, 0.0f);
     for (UInt32 i = 0; i < frameCount; ++i) {
       for (UInt32 ch = 0; ch < outChannels; ++ch) {
@@ -2863,9 +4593,13 @@ extern "C" {
 
 FFI_PLUGIN_EXPORT int32_t wajuce_context_create(int32_t sr, int32_t bs,
                                                 int32_t inCh, int32_t outCh) {
-  auto engine =
-      std::make_shared<wajuce::Engine>((double)sr, bs, inCh, outCh);
   std::lock_guard<std::mutex> lock(wajuce::g_engineMtx);
+  const uint32_t route = wajuce::allocateRouteLocked();
+  auto engine = std::make_shared<wajuce::Engine>(
+      (double)sr, bs, inCh, outCh, route, wajuce::g_routeGenerations[route]);
+  if (route != 0) {
+    std::atomic_store(&wajuce::g_engineRoutes[route], engine);
+  }
   const int32_t id = wajuce::g_nextCtxId++;
   wajuce::g_engines[id] = std::move(engine);
   return id;
@@ -2873,7 +4607,18 @@ FFI_PLUGIN_EXPORT int32_t wajuce_context_create(int32_t sr, int32_t bs,
 
 FFI_PLUGIN_EXPORT void wajuce_context_destroy(int32_t id) {
   std::lock_guard<std::mutex> lock(wajuce::g_engineMtx);
-  wajuce::g_engines.erase(id);
+  auto it = wajuce::g_engines.find(id);
+  if (it == wajuce::g_engines.end()) {
+    return;
+  }
+  const uint32_t route =
+      wajuce::Engine::handleRoute(it->second->getDestinationId());
+  if (route != 0) {
+    std::atomic_store(&wajuce::g_engineRoutes[route],
+                      std::shared_ptr<wajuce::Engine>());
+    wajuce::g_routeGenerations[route] = it->second->retireNodeGenerations();
+  }
+  wajuce::g_engines.erase(it);
 }
 
 FFI_PLUGIN_EXPORT double wajuce_context_get_time(int32_t id) {
@@ -2919,6 +4664,12 @@ wajuce_context_set_preferred_bit_depth(int32_t id, int32_t bitDepth) {
   return e && e->setPreferredBitDepth(bitDepth) ? 1 : 0;
 }
 
+FFI_PLUGIN_EXPORT int32_t
+wajuce_context_set_render_threads(int32_t id, int32_t workerThreads) {
+  auto e = wajuce::getEngine(id);
+  return e && e->setRenderThreadCount(workerThreads) ? 1 : 0;
+}
+
 FFI_PLUGIN_EXPORT int32_t wajuce_context_get_state(int32_t id) {
   auto e = wajuce::getEngine(id);
   return e ? e->getState() : 2;
@@ -3135,7 +4886,7 @@ FFI_PLUGIN_EXPORT void wajuce_disconnect_all(int32_t id, int32_t src) {
 FFI_PLUGIN_EXPORT void wajuce_param_set(int32_t nodeId, const char *param,
                                         float value) {
   if (auto e = wajuce::findEngineForNode(nodeId)) {
-    e->paramSet(nodeId, param, value);
+    e->paramSet(nodeId, e->paramIndex(nodeId, param), value);
   }
 }
 
@@ -3143,7 +4894,7 @@ FFI_PLUGIN_EXPORT void wajuce_param_set_at_time(int32_t nodeId,
                                                 const char *param, float value,
                                                 double time) {
   if (auto e = wajuce::findEngineForNode(nodeId)) {
-    e->paramSetAtTime(nodeId, param, value, time);
+    e->paramSetAtTime(nodeId, e->paramIndex(nodeId, param), value, time);
   }
 }
 
@@ -3151,14 +4902,14 @@ FFI_PLUGIN_EXPORT void wajuce_param_linear_ramp(int32_t nodeId,
                                                 const char *param, float value,
                                                 double endTime) {
   if (auto e = wajuce::findEngineForNode(nodeId)) {
-    e->paramLinearRamp(nodeId, param, value, endTime);
+    e->paramLinearRamp(nodeId, e->paramIndex(nodeId, param), value, endTime);
   }
 }
 
 FFI_PLUGIN_EXPORT void wajuce_param_exp_ramp(int32_t nodeId, const char *param,
                                              float value, double endTime) {
   if (auto e = wajuce::findEngineForNode(nodeId)) {
-    e->paramExpRamp(nodeId, param, value, endTime);
+    e->paramExpRamp(nodeId, e->paramIndex(nodeId, param), value, endTime);
   }
 }
 
@@ -3166,7 +4917,8 @@ FFI_PLUGIN_EXPORT void wajuce_param_set_target(int32_t nodeId,
                                                const char *param, float target,
                                                double startTime, float tc) {
   if (auto e = wajuce::findEngineForNode(nodeId)) {
-    e->paramSetTarget(nodeId, param, target, startTime, tc);
+    e->paramSetTarget(nodeId, e->paramIndex(nodeId, param), target, startTime,
+                      tc);
   }
 }
 
@@ -3174,14 +4926,15 @@ FFI_PLUGIN_EXPORT void wajuce_param_set_value_curve(
     int32_t nodeId, const char *param, const float *values, int32_t length,
     double startTime, double duration) {
   if (auto e = wajuce::findEngineForNode(nodeId)) {
-    e->paramSetValueCurve(nodeId, param, values, length, startTime, duration);
+    e->paramSetValueCurve(nodeId, e->paramIndex(nodeId, param), values, length,
+                          startTime, duration);
   }
 }
 
 FFI_PLUGIN_EXPORT void wajuce_param_cancel(int32_t nodeId, const char *param,
                                            double cancelTime) {
   if (auto e = wajuce::findEngineForNode(nodeId)) {
-    e->paramCancel(nodeId, param, cancelTime);
+    e->paramCancel(nodeId, e->paramIndex(nodeId, param), cancelTime);
   }
 }
 
@@ -3189,17 +4942,121 @@ FFI_PLUGIN_EXPORT void wajuce_param_cancel_and_hold(int32_t nodeId,
                                                     const char *param,
                                                     double time) {
   if (auto e = wajuce::findEngineForNode(nodeId)) {
-    e->paramCancelAndHold(nodeId, param, time);
+    e->paramCancelAndHold(nodeId, e->paramIndex(nodeId, param), time);
   }
 }
 
 FFI_PLUGIN_EXPORT float wajuce_param_get(int32_t nodeId, const char *param) {
   if (auto e = wajuce::findEngineForNode(nodeId)) {
-    return e->paramGet(nodeId, param);
+    return e->paramGet(nodeId, e->paramIndex(nodeId, param));
+  }
+  return 0.0f;
+}
+
+FFI_PLUGIN_EXPORT int32_t wajuce_param_set_automation_rate(int32_t nodeId,
+                                                           const char *param,
+                                                           int32_t rate) {
+  if (auto e = wajuce::findEngineForNode(nodeId)) {
+    return e->paramSetAutomationRate(nodeId, e->paramIndex(nodeId, param),
+                                     rate != 0)
+               ? 1
+               : 0;
+  }
+  return 0;
+}
+
+FFI_PLUGIN_EXPORT int32_t wajuce_param_get_index(int32_t nodeId,
+                                               const char *param) {
+  if (auto e = wajuce::findEngineForNode(nodeId)) {
+    return e->paramIndex(nodeId, param);
+  }
+  return -1;
+}
+
+FFI_PLUGIN_EXPORT void wajuce_param_set_by_index(int32_t nodeId, int32_t index,
+                                                 float value) {
+  if (auto e = wajuce::findEngineForNode(nodeId)) {
+    e->paramSet(nodeId, index, value);
+  }
+}
+
+FFI_PLUGIN_EXPORT void wajuce_param_set_at_time_by_index(int32_t nodeId,
+                                                         int32_t index,
+                                                         float value,
+                                                         double time) {
+  if (auto e = wajuce::findEngineForNode(nodeId)) {
+    e->paramSetAtTime(nodeId, index, value, time);
+  }
+}
+
+FFI_PLUGIN_EXPORT void wajuce_param_linear_ramp_by_index(int32_t nodeId,
+                                                         int32_t index,
+                                                         float value,
+                                                         double endTime) {
+  if (auto e = wajuce::findEngineForNode(nodeId)) {
+    e->paramLinearRamp(nodeId, index, value, endTime);
+  }
+}
+
+FFI_PLUGIN_EXPORT void wajuce_param_exp_ramp_by_index(int32_t nodeId,
+                                                      int32_t index,
+                                                      float value,
+                                                      double endTime) {
+  if (auto e = wajuce::findEngineForNode(nodeId)) {
+    e->paramExpRamp(nodeId, index, value, endTime);
+  }
+}
+
+FFI_PLUGIN_EXPORT void wajuce_param_set_target_by_index(int32_t nodeId,
+                                                        int32_t index,
+                                                        float target,
+                                                        double startTime,
+                                                        float tc) {
+  if (auto e = wajuce::findEngineForNode(nodeId)) {
+    e->paramSetTarget(nodeId, index, target, startTime, tc);
+  }
+}
+
+FFI_PLUGIN_EXPORT void wajuce_param_set_value_curve_by_index(
+    int32_t nodeId, int32_t index, const float *values, int32_t length,
+    double startTime, double duration) {
+  if (auto e = wajuce::findEngineForNode(nodeId)) {
+    e->paramSetValueCurve(nodeId, index, values, length, startTime, duration);
+  }
+}
+
+FFI_PLUGIN_EXPORT void wajuce_param_cancel_by_index(int32_t nodeId,
+                                                    int32_t index,
+                                                    double cancelTime) {
+  if (auto e = wajuce::findEngineForNode(nodeId)) {
+    e->paramCancel(nodeId, index, cancelTime);
+  }
+}
+
+FFI_PLUGIN_EXPORT void wajuce_param_cancel_and_hold_by_index(int32_t nodeId,
+                                                             int32_t index,
+                                                             double time) {
+  if (auto e = wajuce::findEngineForNode(nodeId)) {
+    e->paramCancelAndHold(nodeId, index, time);
+  }
+}
+
+FFI_PLUGIN_EXPORT float wajuce_param_get_by_index(int32_t nodeId,
+                                                  int32_t index) {
+  if (auto e = wajuce::findEngineForNode(nodeId)) {
+    return e->paramGet(nodeId, index);
   }
   return 0.0f;
 }
 
+FFI_PLUGIN_EXPORT int32_t wajuce_param_set_automation_rate_by_index(
+    int32_t nodeId, int32_t index, int32_t rate) {
+  if (auto e = wajuce::findEngineForNode(nodeId)) {
+    return e->paramSetAutomationRate(nodeId, index, rate != 0) ? 1 : 0;
+  }
+  return 0;
+}
+
 FFI_PLUGIN_EXPORT void wajuce_osc_set_type(int32_t nodeId, int32_t type) {
   if (auto e = wajuce::findEngineForNode(nodeId)) {
     e->oscSetType(nodeId, type);
@@ -3362,6 +5219,13 @@ FFI_PLUGIN_EXPORT float wajuce_compressor_get_reduction(int32_t nodeId) {
   return 0.0f;
 }
 
+FFI_PLUGIN_EXPORT void wajuce_compressor_set_lookahead(int32_t nodeId,
+                                                       double seconds) {
+  if (auto e = wajuce::findEngineForNode(nodeId)) {
+    e->compressorSetLookahead(nodeId, seconds);
+  }
+}
+
 FFI_PLUGIN_EXPORT void wajuce_panner_set_panning_model(int32_t nodeId,
                                                        int32_t model) {
   if (auto e = wajuce::findEngineForNode(nodeId)) {
@@ -3555,7 +5419,11 @@ FFI_PLUGIN_EXPORT int32_t wajuce_context_render(int32_t ctxId, float *outData,
                                                 int32_t frames,
                                                 int32_t channels) {
   auto e = wajuce::getEngine(ctxId);
-  return e ? e->render(outData, frames, channels) : 0;
+  if (!e) {
+    return 0;
+  }
+  e->prepareRenderChannels(channels);
+  return e->render(outData, frames, channels);
 }
 
 FFI_PLUGIN_EXPORT void wajuce_context_set_input_buffer(int32_t ctxId,
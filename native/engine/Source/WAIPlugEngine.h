@@ -1,13 +1,20 @@
 #pragma once
 
+#include "Convolver.h"
+#include "FFT.h"
 #include "ParamAutomation.h"
 #include "RingBuffer.h"
+#include "Wavetable.h"
 
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -43,8 +50,13 @@ struct WorkletBridgeState {
 
 class Engine : public std::enable_shared_from_this<Engine> {
 public:
+  // `route` is stamped into every node handle so node-scoped C calls can
+  // find this engine without asking each context (see `handleRoute`).
+  // `generations` carries on the slot generations of the engine that last
+  // held the route, as returned by retireNodeGenerations().
   Engine(double sampleRate = 44100.0, int bufferSize = 512,
-         int inputChannels = 2, int outputChannels = 2);
+         int inputChannels = 2, int outputChannels = 2, uint32_t route = 0,
+         const std::vector<uint32_t> &generations = {});
   ~Engine();
 
   void resume();
@@ -61,13 +73,24 @@ public:
   int getCurrentBitDepth() const {
     return preferredBitDepth.load(std::memory_order_relaxed);
   }
-  int32_t getDestinationId() const { return 0; }
+  int32_t getDestinationId() const { return destinationNodeId; }
+  // Stops handing out node handles and returns the generation every slot
+  // would use next, for the next engine on this route.
+  std::vector<uint32_t> retireNodeGenerations();
+  // The route an engine was created with, read back from one of its node
+  // handles. Route 0 is left to engines nobody routes to.
+  static constexpr int kNodeRouteBits = 6;
+  static constexpr uint32_t kMaxNodeRoutes = 1u << kNodeRouteBits;
+  static uint32_t handleRoute(int32_t nodeId) {
+    return nodeId < 0 ? 0u : static_cast<uint32_t>(nodeId) >> kNodeRouteShift;
+  }
   int32_t getListenerId() const { return listenerNodeId; }
   int32_t getLiveNodeCount();
   int32_t getFeedbackBridgeCount() const { return feedbackCycleCount.load(); }
   int32_t getMachineVoiceGroupCount();
   bool setPreferredSampleRate(double preferredSampleRate);
   bool setPreferredBitDepth(int preferredBitDepth);
+  bool setRenderThreadCount(int workerThreads);
 
   int32_t createGain();
   int32_t createOscillator();
@@ -104,20 +127,24 @@ public:
   void disconnectAll(int32_t srcId);
   bool containsNode(int32_t nodeId);
 
-  void paramSet(int32_t nodeId, const char *param, float value);
-  void paramSetAtTime(int32_t nodeId, const char *param, float value,
+  // Params are addressed by the slot their node kind registers them in.
+  // `paramIndex` resolves a name once; it returns -1 for unknown names.
+  int32_t paramIndex(int32_t nodeId, const char *param);
+  void paramSet(int32_t nodeId, int32_t param, float value);
+  void paramSetAtTime(int32_t nodeId, int32_t param, float value,
                       double time);
-  void paramLinearRamp(int32_t nodeId, const char *param, float value,
+  void paramLinearRamp(int32_t nodeId, int32_t param, float value,
                        double endTime);
-  void paramExpRamp(int32_t nodeId, const char *param, float value,
+  void paramExpRamp(int32_t nodeId, int32_t param, float value,
                     double endTime);
-  void paramSetTarget(int32_t nodeId, const char *param, float target,
+  void paramSetTarget(int32_t nodeId, int32_t param, float target,
                       double startTime, float tc);
-  void paramCancel(int32_t nodeId, const char *param, double cancelTime);
-  void paramCancelAndHold(int32_t nodeId, const char *param, double time);
-  void paramSetValueCurve(int32_t nodeId, const char *param, const float *values,
+  void paramCancel(int32_t nodeId, int32_t param, double cancelTime);
+  void paramCancelAndHold(int32_t nodeId, int32_t param, double time);
+  void paramSetValueCurve(int32_t nodeId, int32_t param, const float *values,
                           int32_t length, double startTime, double duration);
-  float paramGet(int32_t nodeId, const char *param);
+  float paramGet(int32_t nodeId, int32_t param);
+  bool paramSetAutomationRate(int32_t nodeId, int32_t param, bool kRate);
 
   void oscSetType(int32_t nodeId, int type);
   void oscStart(int32_t nodeId, double when);
@@ -152,6 +179,7 @@ public:
                                float *magResponse, float *phaseResponse,
                                int32_t len);
   float compressorGetReduction(int32_t nodeId);
+  void compressorSetLookahead(int32_t nodeId, double seconds);
   void pannerSetPanningModel(int32_t nodeId, int model);
   void pannerSetDistanceModel(int32_t nodeId, int model);
   void pannerSetRefDistance(int32_t nodeId, double value);
@@ -166,6 +194,7 @@ public:
   void convolverSetBuffer(int32_t nodeId, const float *data, int32_t frames,
                           int32_t channels, int32_t sr, bool normalize);
   void convolverSetNormalize(int32_t nodeId, bool normalize);
+  void prepareRenderChannels(int32_t channels);
   void requestMediaInput();
 
   std::shared_ptr<WorkletBridgeState> getWorkletBridgeState(int32_t nodeId);
@@ -180,10 +209,13 @@ public:
   void setMachineVoiceActive(int32_t nodeId, bool active);
 
 public:
+  // `silent` promises that every sample is zero. Writers leave it alone, so a
+  // stale `false` only costs work; the render step sets it when it knows.
   struct AudioBus {
     int channels = 0;
     int frames = 0;
     std::vector<float> samples;
+    bool silent = true;
 
     void resize(int nextChannels, int nextFrames);
     void clear();
@@ -221,29 +253,82 @@ public:
     float y2 = 0.0f;
   };
 
-  struct Node {
-    int32_t id = -1;
-    NodeKind kind = NodeKind::Gain;
-    int32_t inputCount = 1;
-    int32_t outputCount = 1;
-    std::unordered_map<std::string, float> paramValues;
-    std::unordered_map<std::string, std::unique_ptr<ParamTimeline>> timelines;
-    AudioBus current;
-    AudioBus previous;
-    uint64_t renderSerial = 0;
+  struct BiquadCoefficients {
+    float b0 = 1.0f;
+    float b1 = 0.0f;
+    float b2 = 0.0f;
+    float a1 = 0.0f;
+    float a2 = 0.0f;
+  };
+
+  struct Node;
+  struct RenderStep;
+
+  struct Connection {
+    int32_t src = -1;
+    int32_t dst = -1;
+    int output = 0;
+    int input = 0;
+  };
+
+  struct ParamConnection {
+    int32_t src = -1;
+    int32_t dst = -1;
+    int32_t param = -1;
+    int output = 0;
+  };
+
+  // One AudioParam of a node. Each kind registers its params in a fixed
+  // order, so a slot index stays valid for the node's lifetime.
+  struct ParamSlot {
+    std::string name;
+    std::unique_ptr<ParamTimeline> timeline;
+    // The spec pins this param to k-rate; automationRate changes are refused.
+    bool fixedRate = false;
+  };
 
+  // Kind-specific node state. Each node allocates only the block its kind
+  // uses; the shared Node header stays small so the render loop touches less
+  // memory per step.
+  struct OscillatorState {
     int oscillatorType = 0;
     double phase = 0.0;
-    double startTime = -1.0;
-    double stopTime = 1.0e15;
-    std::vector<float> periodicWave;
+    std::shared_ptr<const Wavetable> periodicWave;
+  };
 
-    int filterType = 0;
+  struct FilterState {
+    std::atomic<int> filterType{0};
     std::vector<BiquadState> biquad;
+    // Coefficients and the design inputs they came from; unchanged inputs
+    // reuse them instead of re-running the trig.
+    BiquadCoefficients coefficients;
+    int coefficientType = -1;
+    float coefficientFrequency = 0.0f;
+    float coefficientQ = 0.0f;
+    float coefficientGain = 0.0f;
+    double coefficientSampleRate = 0.0;
+  };
 
-    float compressorReduction = 0.0f;
+  struct CompressorState {
+    std::atomic<float> compressorReduction{0.0f};
+    // Gain reduction in dB, shared by every channel.
     float compressorEnvelope = 0.0f;
+    // Smoothing coefficients and the attack, release and sample rate they
+    // were computed for.
+    float compressorAttackTime = -1.0f;
+    float compressorReleaseTime = -1.0f;
+    double compressorCoefficientRate = 0.0;
+    float compressorAttackCoeff = 0.0f;
+    float compressorReleaseCoeff = 0.0f;
+    // One delay line per channel when lookahead is on, all sharing
+    // compressorLookaheadWrite.
+    std::vector<std::vector<float>> compressorLookaheadLines;
+    int compressorLookaheadWrite = 0;
+    // Line length last requested. Guarded by graphMtx.
+    size_t compressorLookaheadFrames = 0;
+  };
 
+  struct PannerState {
     int panningModel = 1;
     int distanceModel = 1;
     float refDistance = 1.0f;
@@ -252,11 +337,15 @@ public:
     float coneInnerAngle = 360.0f;
     float coneOuterAngle = 360.0f;
     float coneOuterGain = 0.0f;
+  };
 
+  struct DelayState {
     float maxDelay = 1.0f;
     int delayWrite = 0;
     std::vector<std::vector<float>> delayLines;
+  };
 
+  struct BufferSourceState {
     std::vector<float> sourceBuffer;
     int32_t sourceFrames = 0;
     int32_t sourceChannels = 0;
@@ -271,87 +360,252 @@ public:
     double sourceLoopStart = 0.0;
     double sourceLoopEnd = 0.0;
     float sourceEnvelope = 1.0f;
+  };
 
+  struct AnalyserState {
+    // Guards the fields down to analyserWrite. The render thread only
+    // try_locks it.
+    std::mutex analyserMtx;
     int analyserFftSize = 2048;
     float analyserMinDecibels = -100.0f;
     float analyserMaxDecibels = -30.0f;
     float analyserSmoothing = 0.8f;
+    // The last analyserFftSize input samples as a ring; analyserWrite is the
+    // next slot to fill and so also the oldest sample.
     std::vector<float> analyserTime;
+    size_t analyserWrite = 0;
+    // Control-thread state, serialized by graphMtx.
     std::vector<float> analyserPreviousDb;
+    // Transform, Hann window and work buffers for analyserFftSize, rebuilt
+    // when the size changes.
+    std::unique_ptr<RealFFT<float>> analyserFft;
+    std::vector<float> analyserWindow;
+    std::vector<float> analyserFrame;
+    std::vector<std::complex<float>> analyserSpectrum;
+  };
 
+  struct WaveShaperState {
     std::vector<float> waveShaperCurve;
     int waveShaperOversample = 0;
+    bool waveShaperZeroAtRest = true;
+  };
 
-    std::vector<float> convolverBuffer;
+  struct ConvolverState {
     int32_t convolverFrames = 0;
     int32_t convolverChannels = 0;
     int32_t convolverSampleRate = 44100;
     bool convolverNormalize = true;
-    std::vector<std::vector<float>> convolverHistory;
-    int convolverWrite = 0;
+    std::shared_ptr<const ConvolverKernel> convolverKernel;
+    PartitionedConvolver convolverEngine;
+    std::vector<const float *> convolverInputs;
+    std::vector<float *> convolverOutputs;
+    // The response being replaced keeps running while it is crossfaded out
+    // over convolverFadeLength frames.
+    PartitionedConvolver convolverFading;
+    AudioBus convolverFadeBus;
+    int convolverFadeLength = 0;
+    int convolverFadeFrames = 0;
+    // A response that arrives mid-fade waits here until the fade is over.
+    // Once it has been swapped in, the slot parks the engine that finished
+    // fading out until the next setBuffer command takes it off the render
+    // thread.
+    std::shared_ptr<const ConvolverKernel> convolverPendingKernel;
+    PartitionedConvolver convolverPending;
+    int convolverPendingFadeLength = 0;
+    bool convolverPendingReady = false;
+    // Latest setBuffer call; older preparations are dropped. Guarded by
+    // graphMtx.
+    uint64_t convolverRequest = 0;
+    // The response last posted and the channel count its engine was prepared
+    // for, kept so a channel change can re-prepare it. Guarded by graphMtx.
+    std::shared_ptr<const ConvolverKernel> convolverPostedKernel;
+    int convolverPostedChannels = 0;
+  };
 
+  struct IIRState {
     std::vector<double> iirFeedforward;
     std::vector<double> iirFeedback;
     std::vector<std::vector<float>> iirInputHistory;
     std::vector<std::vector<float>> iirOutputHistory;
+  };
 
+  struct WorkletState {
     std::shared_ptr<WorkletBridgeState> bridge;
     std::vector<float> workletLastOutput;
+  };
+
+  struct Node {
+    int32_t id = -1;
+    NodeKind kind = NodeKind::Gain;
+    int32_t inputCount = 1;
+    int32_t outputCount = 1;
+    std::vector<ParamSlot> params;
+    AudioBus current;
+    AudioBus previous;
+    uint64_t renderSerial = 0;
+
+    // Scheduled start/stop shared by oscillators and constant sources.
+    double startTime = -1.0;
+    double stopTime = 1.0e15;
+
+    std::unique_ptr<OscillatorState> oscillator;
+    std::unique_ptr<FilterState> filter;
+    std::unique_ptr<CompressorState> compressor;
+    std::unique_ptr<PannerState> panner;
+    std::unique_ptr<DelayState> delay;
+    std::unique_ptr<BufferSourceState> source;
+    std::unique_ptr<AnalyserState> analyser;
+    std::unique_ptr<WaveShaperState> shaper;
+    std::unique_ptr<ConvolverState> convolver;
+    std::unique_ptr<IIRState> iir;
+    std::unique_ptr<WorkletState> worklet;
+
     std::shared_ptr<std::atomic<bool>> machineActive;
     bool allowSilentInputSkip = false;
+
+    // Incoming edges in connect order, mirrored from the engine-wide lists so
+    // the render path only visits the edges that terminate at this node.
+    std::vector<Connection> inputEdges;
+    std::vector<ParamConnection> paramInputEdges;
+    uint8_t planMark = 0;
+
+    // Owned by the render thread: the step of the installed plan, if any.
+    const RenderStep *step = nullptr;
+    bool renderSkipped = false;
+    // Set when the node passes a single upstream bus through unchanged.
+    const AudioBus *alias = nullptr;
+
+    const AudioBus &output() const { return alias ? *alias : current; }
+    // Frames rendered since the input last carried signal; stateful nodes go
+    // idle once it exceeds their tail.
+    int64_t silentInputFrames = 0;
+
+    // Render-thread scratch, sized when the node is created so steady-state
+    // blocks reuse capacity instead of allocating. `blocks` holds one
+    // per-frame buffer for each automation curve the kernel evaluates.
+    AudioBus input;
+    std::vector<std::vector<float>> blocks;
   };
 
-  struct Connection {
-    int32_t src = -1;
-    int32_t dst = -1;
+  // Connections resolved to their source node when the render plan is
+  // compiled. Feedback routes read the source's previous block to break a
+  // cycle.
+  struct InputRoute {
+    Node *src = nullptr;
+    bool feedback = false;
     int output = 0;
     int input = 0;
   };
 
-  struct ParamConnection {
-    int32_t src = -1;
-    int32_t dst = -1;
-    std::string param;
+  struct ParamRoute {
+    int32_t param = -1;
+    Node *src = nullptr;
+    bool feedback = false;
     int output = 0;
   };
 
+  // One entry of the compiled render plan. `pulls` lists the upstream nodes
+  // this node renders from in the current block (feedback routes excluded).
+  // `dependents` and `dependencyCount` drive the parallel renderer: a step
+  // becomes ready once every step it depends on has rendered.
+  struct RenderStep {
+    Node *node = nullptr;
+    std::vector<Node *> pulls;
+    std::vector<InputRoute> inputs;
+    std::vector<ParamRoute> params;
+    std::vector<uint32_t> dependents;
+    int dependencyCount = 0;
+  };
+
+  // Compiled on the control thread and handed to the render thread through
+  // the command queue. `detached` lists live nodes that are no longer
+  // reachable from the destination; `feedbackSources` lists the nodes read
+  // through a feedback route, the only ones whose previous block is kept.
+  struct RenderPlan {
+    std::vector<RenderStep> steps;
+    RenderStep listener;
+    std::vector<Node *> detached;
+    std::vector<Node *> feedbackSources;
+    // Per-quantum scheduling state for the parallel renderer.
+    std::vector<std::atomic<int>> pending;
+    std::vector<std::atomic<int>> ready;
+  };
+
 private:
-  int32_t addNode(Node node);
+  int32_t addNode(std::unique_ptr<Node> node);
+  std::unique_ptr<Node> takeNodeUnlocked(int32_t nodeId);
+  void releaseNodeSlotUnlocked(uint32_t slot);
+  void prepareRenderScratch(Node &node, int channels, int frames);
   Node *findNodeUnlocked(int32_t nodeId);
   const Node *findNodeUnlocked(int32_t nodeId) const;
-  ParamTimeline &timelineFor(Node &node, const std::string &param);
-  float currentParam(Node &node, const char *param, float fallback);
-  void paramBlock(Node &node, const char *param, float fallback,
-                  double blockStart, int frames, std::vector<int32_t> &stack,
-                  std::vector<float> &values);
-  void addParamInputBlock(Node &node, const char *param,
-                          std::vector<int32_t> &stack,
-                          std::vector<float> &values);
-
-  AudioBus &renderNode(int32_t nodeId, std::vector<int32_t> &stack);
-  void sumInputs(Node &node, std::vector<int32_t> &stack, AudioBus &input);
-  void processNode(Node &node, const AudioBus &input,
-                   std::vector<int32_t> &stack);
+  Node *findNodeUnlocked(int32_t nodeId, NodeKind kind);
+  template <typename Fn> void forEachNodeUnlocked(Fn &&fn) {
+    for (auto &slot : nodeSlots) {
+      if (slot.node) {
+        fn(*slot.node);
+      }
+    }
+  }
+  int32_t paramIndexUnlocked(Node &node, const char *param);
+  ParamTimeline *timelineFor(Node &node, int32_t param);
+  template <typename Schedule>
+  void postAutomationUnlocked(ParamTimeline *timeline, Schedule schedule);
+  float currentParam(Node &node, int32_t param, float fallback);
+  // Fills `values` for the current quantum and returns true when every
+  // sample holds values[0], so kernels can take a scalar path.
+  bool paramBlock(Node &node, int32_t param, float fallback,
+                  double blockStart, int frames, std::vector<float> &values);
+  bool addParamInputBlock(Node &node, int32_t param, float *values,
+                          int frames);
+
+  void postCommandUnlocked(std::function<void()> command);
+  bool applyCommandsFromControlUnlocked();
+  void waitForCommandsUnlocked();
+  void applyPendingCommands();
+  void retireNodeUnlocked(std::unique_ptr<Node> node);
+  void collectRetiredNodesUnlocked();
+
+  void markRenderPlanDirtyUnlocked();
+  void publishRenderPlanUnlocked();
+  void planNodeUnlocked(Node &node, RenderPlan &plan);
+  void planParamInputsUnlocked(Node &node, RenderPlan &plan, RenderStep &step,
+                               std::vector<ParamRoute> &routes);
+  void installRenderPlan(RenderPlan &plan);
+  void demandRenderPlan();
+  const AudioBus *passThroughInput(const Node &node) const;
+  bool inputsSilent(const Node &node) const;
+  bool sourceIsIdle(const Node &node) const;
+  bool idleOnSilentInput(Node &node);
+  void advanceParams(Node &node);
+  void renderStep(RenderStep &step);
+  void renderStepsParallel();
+  void runRenderTasks();
+  void pushReadyStep(int index);
+  int popReadyStep();
+  void renderWorkerMain();
+  void stopRenderWorkersUnlocked();
+  void runPreparation(std::function<void()> job);
+  void preparationWorkerMain();
+  void stopPreparationWorker();
+  void prepareConvolverChannels(int32_t nodeId);
+  void postCompressorLookaheadUnlocked(Node &node);
+  void sumInputs(Node &node, AudioBus &input);
+  void processNode(Node &node, const AudioBus &input);
   void copyCurrentToPrevious();
-  bool hasParamInputUnlocked(int32_t nodeId, const char *param) const;
-  bool canSkipInactiveMachineNodeUnlocked(Node &node) const;
-  bool canSkipSilentGainUnlocked(Node &node);
-
-  void renderOscillator(Node &node, std::vector<int32_t> &stack);
-  void renderConstantSource(Node &node, std::vector<int32_t> &stack);
-  void renderBufferSource(Node &node, std::vector<int32_t> &stack);
-  void renderBiquad(Node &node, const AudioBus &input,
-                    std::vector<int32_t> &stack);
+  bool hasParamInput(const Node &node, int32_t param) const;
+  bool canSkipInactiveMachineNode(Node &node) const;
+  bool canSkipSilentGain(Node &node);
+
+  void renderOscillator(Node &node);
+  void renderConstantSource(Node &node);
+  void renderBufferSource(Node &node);
+  void renderBiquad(Node &node);
   void renderIIRFilter(Node &node, const AudioBus &input);
-  void renderDelay(Node &node, const AudioBus &input,
-                   std::vector<int32_t> &stack);
-  void renderCompressor(Node &node, const AudioBus &input,
-                        std::vector<int32_t> &stack);
-  void renderStereoPanner(Node &node, const AudioBus &input,
-                          std::vector<int32_t> &stack);
-  void renderPanner(Node &node, const AudioBus &input,
-                    std::vector<int32_t> &stack);
-  void renderWaveShaper(Node &node, const AudioBus &input);
+  void renderDelay(Node &node, const AudioBus &input);
+  void renderCompressor(Node &node);
+  void renderStereoPanner(Node &node, const AudioBus &input);
+  void renderPanner(Node &node, const AudioBus &input);
+  void renderWaveShaper(Node &node);
   void renderConvolver(Node &node, const AudioBus &input);
   void renderAnalyser(Node &node, const AudioBus &input);
   void renderMediaStreamSource(Node &node);
@@ -380,25 +634,105 @@ private:
                                          AudioBufferList *ioData);
   AudioComponentInstance appleAudioUnit = nullptr;
   bool appleAudioUnitOpen = false;
+  std::vector<uint8_t> appleInputList;
+  std::vector<float> appleInputPlanar;
 #endif
 
+  // Serializes control-thread callers. The render thread never takes it;
+  // control changes reach the render state through `commands`.
   mutable std::recursive_mutex graphMtx;
   mutable std::mutex machineVoiceActiveMtx;
-  std::unordered_map<int32_t, Node> nodes;
+  // Node handles are `route << kNodeRouteShift | generation << kNodeSlotBits
+  // | slot`. A freed slot bumps its generation, so a stale handle misses
+  // instead of reaching the node that reused the slot.
+  //
+  // The generation wraps, so a stale handle can still alias once its slot has
+  // been reused 2^kNodeGenerationBits times. Freed slots are reused oldest
+  // first and only while more than kMinFreeNodeSlots are free, which keeps
+  // that window at roughly half a million node creations. A route's
+  // generations pass to the next engine that takes it, so handles kept from a
+  // destroyed context fall under the same window instead of resolving in the
+  // new one straight away.
+  struct NodeSlot {
+    std::unique_ptr<Node> node;
+    uint32_t generation = 0;
+  };
+  static constexpr int kNodeSlotBits = 16;
+  static constexpr uint32_t kNodeSlotMask = (1u << kNodeSlotBits) - 1u;
+  static constexpr int kNodeGenerationBits = 9;
+  static constexpr uint32_t kNodeGenerationMask =
+      (1u << kNodeGenerationBits) - 1u;
+  static constexpr size_t kMinFreeNodeSlots = 1024;
+  static constexpr int kNodeRouteShift = kNodeSlotBits + kNodeGenerationBits;
+  static_assert(kNodeRouteShift + kNodeRouteBits == 31,
+                "node handles must stay non-negative int32 values");
+  int32_t composeHandle(uint32_t generation, uint32_t slot) const {
+    return static_cast<int32_t>((nodeRoute << kNodeRouteShift) |
+                                (generation << kNodeSlotBits) | slot);
+  }
+  const uint32_t nodeRoute;
+  int32_t destinationNodeId = 0;
+  std::vector<NodeSlot> nodeSlots;
+  std::deque<uint32_t> freeNodeSlots;
+  int32_t liveNodeCount = 0;
+  bool nodeHandlesRetired = false;
   std::vector<Connection> connections;
   std::vector<ParamConnection> paramConnections;
+  bool renderPlanDirty = false;
+  int renderPlanBatchDepth = 0;
+
+  SPSCSlotQueue<std::function<void()>> commands{4096};
+  uint64_t postedCommands = 0;
+  std::atomic<uint64_t> appliedCommands{0};
+  std::atomic<bool> renderInFlight{false};
+  std::atomic<bool> controlApplying{false};
+  std::vector<std::pair<uint64_t, std::unique_ptr<Node>>> retiredNodes;
+
+  // Optional parallel renderer. Workers only touch the plan while
+  // `renderTasksOpen` is set, and the render thread always works through the
+  // ready queue itself, so a quantum completes even when no worker wakes up.
+  std::vector<std::thread> renderWorkers;
+  std::atomic<int> renderWorkerCount{0};
+  std::mutex renderWorkerMtx;
+  std::condition_variable renderWorkerWake;
+  std::atomic<bool> renderWorkersExit{false};
+  std::atomic<uint64_t> renderWorkerGeneration{0};
+  std::atomic<bool> renderTasksOpen{false};
+  std::atomic<int> renderTasksActive{0};
+  std::atomic<int> renderTasksRemaining{0};
+  std::atomic<size_t> readyHead{0};
+  std::atomic<size_t> readyTail{0};
+
+  // Background worker for slow control-side preparation, such as convolver
+  // responses. Started on first use; jobs run in order.
+  std::thread preparationWorker;
+  std::mutex preparationMtx;
+  std::condition_variable preparationWake;
+  std::deque<std::function<void()>> preparationJobs;
+  bool preparationExit = false;
+  // Channel count per-channel node state is built for on the control side:
+  // convolver engines and compressor lookahead lines. Partitioning never runs
+  // on the render thread, so a render at another count leaves convolvers
+  // silent until prepareRenderChannels() has re-prepared them.
+  std::atomic<int> preparedChannelCount{1};
+
+  // Render-thread state.
+  RenderPlan renderPlan;
+  Node *destinationNode = nullptr;
+  Node *listenerNode = nullptr;
   std::unordered_map<int32_t, std::vector<int32_t>> machineVoiceGroups;
   std::unordered_map<int32_t, int32_t> machineVoiceRootByNode;
   std::unordered_map<int32_t, std::shared_ptr<std::atomic<bool>>>
       machineVoiceActiveByNode;
-  int32_t nextNodeId = 1;
   int32_t listenerNodeId = -1;
   uint64_t renderSerial = 0;
   int renderFrames = 0;
+  // Frame offset of the current quantum inside the caller's block.
+  int renderOffset = 0;
   int renderChannels = 2;
   double renderBlockStartTime = 0.0;
-  std::vector<float> scratchParam;
   AudioBus realtimeInput;
+  std::vector<float> realtimeOutput;
 
   std::atomic<double> sampleRate{44100.0};
   std::atomic<int> bufferSize{512};
@@ -0,0 +1,181 @@
+#pragma once
+/**
+ * Wavetable.h — Band-limited oscillator tables.
+ * Stores a periodic waveform as one table per octave; each table carries only
+ * the partials that stay below Nyquist for the pitches that read it.
+ */
+
+#include "FFT.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace wajuce {
+
+class Wavetable {
+public:
+  static constexpr int kSize = 2048;
+  // Level 0 holds kSize / 2 partials; every level above halves that, down to
+  // a lone fundamental.
+  static constexpr int kLevels = 11;
+
+  // sine[n] and cosine[n] weight partial n (entry 0 is ignored). With
+  // normalize set, the full-band table is scaled to a peak of 1 and the other
+  // levels share that gain so loudness does not step between octaves.
+  void build(const double *sine, const double *cosine, int count,
+             bool normalize) {
+    // Each level is one inverse FFT of the partials it keeps.
+    const FFT<double> fft(kSize);
+    std::vector<std::complex<double>> spectrum(static_cast<size_t>(kSize));
+    std::array<std::vector<double>, kLevels> levels;
+    for (int level = 0; level < kLevels; ++level) {
+      std::fill(spectrum.begin(), spectrum.end(), std::complex<double>());
+      const int limit = std::min(partialsAt(level), count - 1);
+      for (int n = 1; n <= limit; ++n) {
+        spectrum[static_cast<size_t>(n)] = {cosine[n], -sine[n]};
+      }
+      fft.transform(spectrum.data(), true);
+      auto &samples = levels[static_cast<size_t>(level)];
+      samples.resize(static_cast<size_t>(kSize));
+      for (int j = 0; j < kSize; ++j) {
+        samples[static_cast<size_t>(j)] =
+            spectrum[static_cast<size_t>(j)].real();
+      }
+    }
+
+    double scale = 1.0;
+    if (normalize) {
+      double peak = 0.0;
+      for (double v : levels[0]) {
+        peak = std::max(peak, std::abs(v));
+      }
+      scale = peak > 0.0 ? 1.0 / peak : 1.0;
+    }
+    for (int level = 0; level < kLevels; ++level) {
+      auto &table = tables[static_cast<size_t>(level)];
+      const auto &source = levels[static_cast<size_t>(level)];
+      table.resize(static_cast<size_t>(kSize + kGuard));
+      for (int j = 0; j < kSize + kGuard; ++j) {
+        table[static_cast<size_t>(j)] = static_cast<float>(
+            source[static_cast<size_t>(j & (kSize - 1))] * scale);
+      }
+    }
+  }
+
+  // The richest table that cannot alias at this phase increment, in cycles
+  // per sample.
+  const float *levelFor(double increment) const {
+    const double nyquistPartials =
+        0.5 / std::max(std::abs(increment), 1.0e-9);
+    int level = 0;
+    while (level < kLevels - 1 && partialsAt(level) > nyquistPartials) {
+      ++level;
+    }
+    return tables[static_cast<size_t>(level)].data();
+  }
+
+  // phase is in [0, 1]; the guard samples cover the wrap without a modulo.
+  static float lookup(const float *table, double phase) {
+    const double index = phase * kSize;
+    const int i0 = static_cast<int>(index);
+    const float frac = static_cast<float>(index - i0);
+    return table[i0] + frac * (table[i0 + 1] - table[i0]);
+  }
+
+private:
+  static constexpr int kGuard = 2;
+
+  static int partialsAt(int level) { return (kSize / 2) >> level; }
+
+  std::array<std::vector<float>, kLevels> tables;
+};
+
+// Tables for the built-in oscillator types (0 sine, 1 square, 2 sawtooth,
+// 3 triangle), shared by every context and built on first use.
+inline const Wavetable &basicWavetable(int type) {
+  static const std::array<Wavetable, 4> basic = [] {
+    constexpr int count = Wavetable::kSize / 2 + 1;
+    constexpr double pi = 3.14159265358979323846264338327950288;
+    std::array<Wavetable, 4> built;
+    std::vector<double> sine(static_cast<size_t>(count), 0.0);
+    const std::vector<double> cosine(static_cast<size_t>(count), 0.0);
+    for (int type = 0; type < 4; ++type) {
+      std::fill(sine.begin(), sine.end(), 0.0);
+      for (int n = 1; n < count; ++n) {
+        const bool odd = (n & 1) != 0;
+        double amplitude = 0.0;
+        switch (type) {
+        case 0:
+          amplitude = n == 1 ? 1.0 : 0.0;
+          break;
+        case 1:
+          amplitude = odd ? 4.0 / (pi * n) : 0.0;
+          break;
+        case 2:
+          amplitude = (odd ? 2.0 : -2.0) / (pi * n);
+          break;
+        case 3:
+          amplitude = odd ? ((n & 3) == 1 ? 8.0 : -8.0) / (pi * pi * n * n)
+                          : 0.0;
+          break;
+        }
+        sine[static_cast<size_t>(n)] = amplitude;
+      }
+      built[static_cast<size_t>(type)].build(sine.data(), cosine.data(), count,
+                                             type != 0);
+    }
+    return built;
+  }();
+  return basic[static_cast<size_t>(std::clamp(type, 0, 3))];
+}
+
+// PeriodicWave tables keyed by their coefficients. Oscillators given the same
+// coefficients share one table, which is freed along with the last of them.
+inline std::shared_ptr<const Wavetable>
+sharedPeriodicWave(const float *real, const float *imag, int len,
+                   bool normalize) {
+  static std::mutex cacheMtx;
+  static std::map<std::vector<float>, std::weak_ptr<const Wavetable>> cache;
+
+  const auto finite = [](float v) { return std::isfinite(v) ? v : 0.0f; };
+  std::vector<float> key;
+  key.reserve(static_cast<size_t>(len) * 2 + 1);
+  key.push_back(normalize ? 1.0f : 0.0f);
+  for (int k = 0; k < len; ++k) {
+    key.push_back(finite(real[k]));
+  }
+  for (int k = 0; k < len; ++k) {
+    key.push_back(finite(imag[k]));
+  }
+
+  std::lock_guard<std::mutex> lock(cacheMtx);
+  if (auto found = cache.find(key); found != cache.end()) {
+    if (auto wave = found->second.lock()) {
+      return wave;
+    }
+  }
+  for (auto it = cache.begin(); it != cache.end();) {
+    it = it->second.expired() ? cache.erase(it) : std::next(it);
+  }
+
+  std::vector<double> sine(static_cast<size_t>(len));
+  std::vector<double> cosine(static_cast<size_t>(len));
+  for (int k = 0; k < len; ++k) {
+    cosine[static_cast<size_t>(k)] = key[static_cast<size_t>(1 + k)];
+    sine[static_cast<size_t>(k)] = key[static_cast<size_t>(1 + len + k)];
+  }
+  auto wave = std::make_shared<Wavetable>();
+  wave->build(sine.data(), cosine.data(), len, normalize);
+  cache[std::move(key)] = wave;
+  return wave;
+}
+
+} // namespace wajuce
@@ -1,10 +1,15 @@
 #include "../../../src/wajuce.h"
+#include "VectorOps.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -121,6 +126,152 @@ int main() {
     wajuce_context_destroy(ctx);
   }
 
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int frames = 128;
+    const int ctx = wajuce_context_create(sampleRate, frames, 0, 1);
+    const int osc = wajuce_create_oscillator(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    // At a quarter of the sample rate every overtone of a square wave lies
+    // above Nyquist, so only the fundamental may remain.
+    wajuce_osc_set_type(osc, 1);
+    wajuce_param_set(osc, "frequency", sampleRate / 4.0f);
+    wajuce_connect(ctx, osc, dest, 0, 0);
+    wajuce_osc_start(osc, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    ok &= expect(std::abs(out[64]) < 0.01f && out[65] > 0.5f &&
+                     std::abs(out[66]) < 0.01f && out[67] < -0.5f,
+                 "square oscillators should be band-limited");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int frames = 256;
+    // A constant detune of an automated frequency must match automating the
+    // detuned frequency directly, for oscillators and filters alike.
+    const auto render = [](float scale, float detune, bool filtered) {
+      const int ctx = wajuce_context_create(44100, 128, 0, 1);
+      const int osc = wajuce_create_oscillator(ctx);
+      const int filter = wajuce_create_biquad_filter(ctx);
+      const int dest = wajuce_context_get_destination_id(ctx);
+      const int tuned = filtered ? filter : osc;
+      wajuce_param_set(tuned, "frequency", 220.0f * scale);
+      wajuce_param_linear_ramp(tuned, "frequency", 880.0f * scale, 0.005);
+      wajuce_param_set(tuned, "detune", detune);
+      wajuce_connect(ctx, osc, filter, 0, 0);
+      wajuce_connect(ctx, filter, dest, 0, 0);
+      wajuce_osc_start(osc, 0.0);
+      std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+      wajuce_context_render(ctx, out.data(), frames, 1);
+      wajuce_context_destroy(ctx);
+      return out;
+    };
+    bool matches = true;
+    for (const bool filtered : {false, true}) {
+      const auto detuned = render(1.0f, 1200.0f, filtered);
+      const auto direct = render(2.0f, 0.0f, filtered);
+      for (int i = 0; i < frames; ++i) {
+        const auto index = static_cast<size_t>(i);
+        matches &= near(detuned[index], direct[index], 1.0e-3f);
+      }
+    }
+    ok &= expect(matches,
+                 "constant detune should scale an automated frequency");
+  }
+
+  {
+    constexpr int frames = 128;
+    const int ctx = wajuce_context_create(44100, 128, 0, 1);
+    const int src = wajuce_create_constant_source(ctx);
+    const int gain = wajuce_create_gain(ctx);
+    const int filter = wajuce_create_biquad_filter(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    const int gainIndex = wajuce_param_get_index(gain, "gain");
+    ok &= expect(gainIndex >= 0 &&
+                     wajuce_param_get_index(filter, "gain") !=
+                         wajuce_param_get_index(filter, "Q") &&
+                     wajuce_param_get_index(gain, "frequency") < 0,
+                 "param names should resolve to per-kind slots");
+    wajuce_connect(ctx, src, gain, 0, 0);
+    wajuce_connect(ctx, gain, dest, 0, 0);
+    wajuce_osc_start(src, 0.0);
+    wajuce_param_set_at_time_by_index(gain, gainIndex, 0.5f, 0.0);
+    wajuce_param_linear_ramp_by_index(gain, gainIndex, 1.0f,
+                                      static_cast<double>(frames) / 44100.0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    ok &= expect(near(out[0], 0.5f, 0.01f) && out[frames - 1] > 0.99f &&
+                     near(wajuce_param_get_by_index(gain, gainIndex),
+                          wajuce_param_get(gain, "gain"), 0.0f),
+                 "index-based param calls should drive the same timeline");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int sampleRate = 1000;
+    constexpr int frames = 400;
+    const int ctx = wajuce_context_create(sampleRate, 128, 0, 1);
+    const int src = wajuce_create_constant_source(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    wajuce_param_set_at_time(src, "offset", 1.0f, 0.0);
+    wajuce_param_exp_ramp(src, "offset", 0.01f, 0.2);
+    wajuce_param_set_target(src, "offset", 0.5f, 0.25, 0.05f);
+    wajuce_connect(ctx, src, dest, 0, 0);
+    wajuce_osc_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    const float target =
+        0.5f + (0.01f - 0.5f) * std::exp(-(0.299f - 0.249f) / 0.05f);
+    const float rampEnd = 0.01f * std::pow(100.0f, 0.005f);
+    ok &= expect(near(out[100], 0.1f, 0.0005f) &&
+                     near(out[199], rampEnd, 0.0005f) &&
+                     near(out[240], 0.01f, 0.0001f) &&
+                     near(out[299], target, 0.002f),
+                 "automation segments should follow ramp and target curves");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int sampleRate = 1000;
+    constexpr int frames = 256;
+    const int ctx = wajuce_context_create(sampleRate, 128, 0, 1);
+    const int src = wajuce_create_constant_source(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    wajuce_param_set_automation_rate(src, "offset", 1);
+    wajuce_param_set_at_time(src, "offset", 0.0f, 0.0);
+    wajuce_param_linear_ramp(src, "offset", 1.0f, 0.256);
+    wajuce_connect(ctx, src, dest, 0, 0);
+    wajuce_osc_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    ok &= expect(out[0] == out[127] && near(out[127], 0.0f, 0.0001f) &&
+                     out[128] == out[frames - 1] &&
+                     near(out[128], 0.5f, 0.0001f),
+                 "k-rate params should hold their quantum-start value");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    const int ctx = wajuce_context_create(44100, 128, 0, 1);
+    const int compressor = wajuce_create_compressor(ctx);
+    const int source = wajuce_create_buffer_source(ctx);
+    const int gain = wajuce_create_gain(ctx);
+    const int rateIndex = wajuce_param_get_index(source, "playbackRate");
+    const bool compressorFixed =
+        wajuce_param_set_automation_rate(compressor, "ratio", 0) == 0 &&
+        wajuce_param_set_automation_rate(compressor, "ratio", 1) == 1;
+    const bool sourceFixed =
+        wajuce_param_set_automation_rate_by_index(source, rateIndex, 0) == 0 &&
+        wajuce_param_set_automation_rate(source, "detune", 0) == 0;
+    const bool gainFree =
+        wajuce_param_set_automation_rate(gain, "gain", 1) == 1 &&
+        wajuce_param_set_automation_rate(gain, "pan", 1) == 0;
+    ok &= expect(compressorFixed && sourceFixed && gainFree,
+                 "fixed-rate params should refuse automationRate changes");
+    wajuce_context_destroy(ctx);
+  }
+
   {
     constexpr int sampleRate = 100;
     constexpr int frames = 16;
@@ -244,6 +395,73 @@ int main() {
     wajuce_context_destroy(ctx);
   }
 
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int steps = 100;
+    constexpr int stride = 64;
+    constexpr int frames = (steps + 2) * stride;
+    const int ctx = wajuce_context_create(sampleRate, 128, 0, 1);
+    const int src = wajuce_create_constant_source(ctx);
+    const int gain = wajuce_create_gain(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    // More events than the timeline starts with, scheduled newest first, so
+    // its storage is replaced while events and a pooled curve are live.
+    const float curve[2] = {2.0f, 2.0f};
+    wajuce_param_set_value_curve(gain, "gain", curve, 2,
+                                 double(steps * stride) / sampleRate,
+                                 double(stride) / sampleRate);
+    for (int i = steps - 1; i >= 0; --i) {
+      wajuce_param_set_at_time(gain, "gain", 0.01f * i,
+                               double(i * stride) / sampleRate);
+    }
+    wajuce_connect(ctx, src, gain, 0, 0);
+    wajuce_connect(ctx, gain, dest, 0, 0);
+    wajuce_osc_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    bool stepsHeld = true;
+    for (int i = 0; i < steps; ++i) {
+      stepsHeld &= near(out[static_cast<size_t>(i * stride + 1)], 0.01f * i,
+                        1.0e-5f);
+    }
+    ok &= expect(stepsHeld && near(out[steps * stride + 10], 2.0f, 1.0e-5f),
+                 "automation should keep its events when the timeline grows");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int sampleRate = 100;
+    constexpr int frames = 100;
+    const int ctx = wajuce_context_create(sampleRate, 16, 0, 1);
+    const int src = wajuce_create_constant_source(ctx);
+    const int gain = wajuce_create_gain(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    // The ramp is scheduled before the event it starts from, the two
+    // set-points at 0.5 s resolve in call order, and the cancel drops only
+    // the set-point after the curve.
+    const float curve[2] = {0.25f, 0.75f};
+    wajuce_param_linear_ramp(gain, "gain", 1.0f, 0.4);
+    wajuce_param_set_at_time(gain, "gain", 0.0f, 0.2);
+    wajuce_param_set_at_time(gain, "gain", 0.5f, 0.5);
+    wajuce_param_set_at_time(gain, "gain", 0.25f, 0.5);
+    wajuce_param_set_value_curve(gain, "gain", curve, 2, 0.6, 0.1);
+    wajuce_param_set_at_time(gain, "gain", 0.9f, 0.8);
+    wajuce_param_cancel(gain, "gain", 0.75);
+    wajuce_connect(ctx, src, gain, 0, 0);
+    wajuce_connect(ctx, gain, dest, 0, 0);
+    wajuce_osc_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    ok &= expect(near(out[10], 1.0f, 1.0e-4f) && near(out[20], 0.0f, 1.0e-4f) &&
+                     near(out[30], 0.5f, 1.0e-4f) &&
+                     near(out[45], 1.0f, 1.0e-4f) &&
+                     near(out[50], 0.25f, 1.0e-4f) &&
+                     near(out[65], 0.5f, 1.0e-4f) &&
+                     near(out[90], 0.75f, 1.0e-4f),
+                 "automation should order, replace and cancel its events");
+    wajuce_context_destroy(ctx);
+  }
+
   {
     constexpr int sampleRate = 10;
     constexpr int frames = 4;
@@ -294,6 +512,34 @@ int main() {
     wajuce_context_destroy(ctx);
   }
 
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int frames = 128;
+    const float real[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    const float imag[4] = {0.0f, 1.0f, 0.0f, 1.0f};
+    const int ctx = wajuce_context_create(sampleRate, frames, 0, 1);
+    const int wave = wajuce_create_oscillator(ctx);
+    const int sine = wajuce_create_oscillator(ctx);
+    const int invert = wajuce_create_gain(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    // At a quarter of the sample rate the third partial would fold back, so
+    // the wave must cancel exactly against a plain sine.
+    wajuce_osc_set_periodic_wave(wave, real, imag, 4, 1);
+    wajuce_param_set(wave, "frequency", sampleRate / 4.0f);
+    wajuce_param_set(sine, "frequency", sampleRate / 4.0f);
+    wajuce_param_set(invert, "gain", -1.0f);
+    wajuce_connect(ctx, wave, invert, 0, 0);
+    wajuce_connect(ctx, invert, dest, 0, 0);
+    wajuce_connect(ctx, sine, dest, 0, 0);
+    wajuce_osc_start(wave, 0.0);
+    wajuce_osc_start(sine, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    ok &= expect(rms(out, frames, 0) < 0.001,
+                 "PeriodicWave partials above Nyquist should be dropped");
+    wajuce_context_destroy(ctx);
+  }
+
   {
     constexpr int sampleRate = 44100;
     constexpr int frames = 44100;
@@ -405,6 +651,389 @@ int main() {
     wajuce_context_destroy(ctx);
   }
 
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int block = 128;
+    constexpr int blocks = 24;
+    const int ctx = wajuce_context_create(sampleRate, block, 0, 1);
+    const int src = wajuce_create_buffer_source(ctx);
+    const int delay = wajuce_create_delay(ctx, 1.0f);
+    const int gain = wajuce_create_gain(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    const float impulse[1] = {1.0f};
+    wajuce_buffer_source_set_buffer(src, impulse, 1, 1, sampleRate);
+    wajuce_param_set(delay, "delayTime", 0.01f);
+    wajuce_param_set(gain, "gain", 0.5f);
+    wajuce_connect(ctx, src, delay, 0, 0);
+    wajuce_connect(ctx, delay, dest, 0, 0);
+    wajuce_connect(ctx, delay, gain, 0, 0);
+    wajuce_connect(ctx, gain, delay, 0, 0);
+    wajuce_buffer_source_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(block * blocks), 0.0f);
+    for (int b = 0; b < blocks; ++b) {
+      wajuce_context_render(ctx, out.data() + b * block, block, 1);
+    }
+    float echo = 0.0f;
+    for (int i = 1000; i < block * blocks; ++i) {
+      echo = std::max(echo, std::abs(out[static_cast<size_t>(i)]));
+    }
+    ok &= expect(near(out[441], 1.0f, 0.01f) && near(echo, 0.5f, 0.01f),
+                 "delay/gain cycle should feed back through the previous "
+                 "block");
+
+    wajuce_disconnect(ctx, delay, dest);
+    std::vector<float> chunk(static_cast<size_t>(block), 0.0f);
+    wajuce_context_render(ctx, chunk.data(), block, 1);
+    ok &= expect(rms(chunk, block, 0) < 0.000001,
+                 "disconnect should recompile the render graph");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int block = 128;
+    constexpr int blocks = 24;
+    const int ctx = wajuce_context_create(sampleRate, block, 0, 1);
+    const int src = wajuce_create_buffer_source(ctx);
+    const int delay = wajuce_create_delay(ctx, 1.0f);
+    const int analyser = wajuce_create_analyser(ctx);
+    const int gain = wajuce_create_gain(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    const float impulse[1] = {1.0f};
+    wajuce_buffer_source_set_buffer(src, impulse, 1, 1, sampleRate);
+    wajuce_param_set(delay, "delayTime", 0.01f);
+    wajuce_param_set(gain, "gain", 0.5f);
+    wajuce_connect(ctx, analyser, dest, 0, 0);
+    wajuce_connect(ctx, src, delay, 0, 0);
+    wajuce_connect(ctx, delay, analyser, 0, 0);
+    wajuce_connect(ctx, analyser, gain, 0, 0);
+    wajuce_connect(ctx, gain, delay, 0, 0);
+    wajuce_buffer_source_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(block * blocks), 0.0f);
+    for (int b = 0; b < blocks; ++b) {
+      wajuce_context_render(ctx, out.data() + b * block, block, 1);
+    }
+    float echo = 0.0f;
+    for (int i = 1000; i < block * blocks; ++i) {
+      echo = std::max(echo, std::abs(out[static_cast<size_t>(i)]));
+    }
+    ok &= expect(near(out[441], 1.0f, 0.01f) && near(echo, 0.5f, 0.01f),
+                 "pass-through nodes should alias their input and still "
+                 "feed a cycle");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int fftSize = 256;
+    const int ctx = wajuce_context_create(sampleRate, 128, 0, 1);
+    const int osc = wajuce_create_oscillator(ctx);
+    const int analyser = wajuce_create_analyser(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    wajuce_analyser_set_fft_size(analyser, fftSize);
+    wajuce_analyser_set_smoothing_time_constant(analyser, 0.0);
+    wajuce_param_set(osc, "frequency", 16.0f * sampleRate / fftSize);
+    wajuce_connect(ctx, osc, analyser, 0, 0);
+    wajuce_connect(ctx, analyser, dest, 0, 0);
+    wajuce_osc_start(osc, 0.0);
+    std::vector<float> out(static_cast<size_t>(fftSize), 0.0f);
+    wajuce_context_render(ctx, out.data(), fftSize, 1);
+    std::vector<float> db(static_cast<size_t>(fftSize / 2), 0.0f);
+    wajuce_analyser_get_float_freq(analyser, db.data(), fftSize / 2);
+    const auto peak = std::max_element(db.begin(), db.end()) - db.begin();
+    // A Hann-windowed full-scale sine lands a quarter of its amplitude in
+    // its bin, about -12 dB.
+    ok &= expect(peak == 16 && near(db[16], -12.0f, 0.2f) && db[64] < -60.0f,
+                 "analyser frequency data should peak at the sine's bin");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int frames = 300;
+    constexpr int fftSize = 32;
+    const int ctx = wajuce_context_create(sampleRate, 128, 0, 1);
+    const int src = wajuce_create_buffer_source(ctx);
+    const int analyser = wajuce_create_analyser(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    std::vector<float> ramp(static_cast<size_t>(frames), 0.0f);
+    for (int i = 0; i < frames; ++i) {
+      ramp[static_cast<size_t>(i)] = static_cast<float>(i) / frames;
+    }
+    wajuce_buffer_source_set_buffer(src, ramp.data(), frames, 1, sampleRate);
+    wajuce_param_set(src, "decay", 10000.0f);
+    wajuce_analyser_set_fft_size(analyser, fftSize);
+    wajuce_connect(ctx, src, analyser, 0, 0);
+    wajuce_connect(ctx, analyser, dest, 0, 0);
+    wajuce_buffer_source_start(src, 0.0);
+    // 300 frames render as two full quanta and a short one, so the newest
+    // samples wrap around the analyser's ring.
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    std::vector<float> time(static_cast<size_t>(fftSize), 0.0f);
+    wajuce_analyser_get_float_time(analyser, time.data(), fftSize);
+    bool ordered = true;
+    for (int i = 0; i < fftSize; ++i) {
+      ordered &= near(time[static_cast<size_t>(i)],
+                      out[static_cast<size_t>(frames - fftSize + i)], 1.0e-6f);
+    }
+    ok &= expect(ordered && time[fftSize - 1] > 0.99f,
+                 "analyser time data should hold the newest samples in order");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int frames = 3000;
+    const int ctx = wajuce_context_create(sampleRate, 512, 0, 1);
+    const int src = wajuce_create_buffer_source(ctx);
+    const int delay = wajuce_create_delay(ctx, 1.0f);
+    const int gain = wajuce_create_gain(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    const float impulse[1] = {1.0f};
+    wajuce_buffer_source_set_buffer(src, impulse, 1, 1, sampleRate);
+    wajuce_param_set(delay, "delayTime", 0.01f);
+    wajuce_param_set(gain, "gain", 0.5f);
+    wajuce_connect(ctx, src, delay, 0, 0);
+    wajuce_connect(ctx, delay, dest, 0, 0);
+    wajuce_connect(ctx, delay, gain, 0, 0);
+    wajuce_connect(ctx, gain, delay, 0, 0);
+    wajuce_buffer_source_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    float echo = 0.0f;
+    for (int i = 1000; i < frames; ++i) {
+      echo = std::max(echo, std::abs(out[static_cast<size_t>(i)]));
+    }
+    ok &= expect(near(out[441], 1.0f, 0.01f) && near(echo, 0.5f, 0.01f) &&
+                     near(static_cast<float>(wajuce_context_get_time(ctx)),
+                          static_cast<float>(frames) / sampleRate, 0.0001f),
+                 "long blocks should render as fixed 128-frame quanta");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int frames = 4096;
+    constexpr int channels = 2;
+    constexpr int voices = 8;
+    auto renderVoices = [&](int workers) {
+      const int ctx = wajuce_context_create(sampleRate, 512, 0, channels);
+      const int dest = wajuce_context_get_destination_id(ctx);
+      const int bus = wajuce_create_gain(ctx);
+      const int delay = wajuce_create_delay(ctx, 0.5f);
+      const int feedback = wajuce_create_gain(ctx);
+      wajuce_param_set(delay, "delayTime", 0.02f);
+      wajuce_param_set(feedback, "gain", 0.4f);
+      wajuce_connect(ctx, bus, dest, 0, 0);
+      wajuce_connect(ctx, bus, delay, 0, 0);
+      wajuce_connect(ctx, delay, feedback, 0, 0);
+      wajuce_connect(ctx, feedback, bus, 0, 0);
+      for (int v = 0; v < voices; ++v) {
+        int32_t ids[7] = {0};
+        wajuce_create_machine_voice(ctx, ids);
+        wajuce_param_set(ids[0], "frequency", 110.0f * (v + 1));
+        wajuce_param_set(ids[2], "gain", 0.1f);
+        wajuce_param_set(ids[3], "pan", -1.0f + 2.0f * v / (voices - 1));
+        wajuce_connect(ctx, ids[3], bus, 0, 0);
+        wajuce_machine_voice_set_active(ctx, ids[0], 1);
+      }
+      for (int p = 0; p < 2; ++p) {
+        const int osc = wajuce_create_oscillator(ctx);
+        const int panner = wajuce_create_panner(ctx);
+        wajuce_param_set(panner, "positionX", p == 0 ? -2.0f : 3.0f);
+        wajuce_connect(ctx, osc, panner, 0, 0);
+        wajuce_connect(ctx, panner, bus, 0, 0);
+        wajuce_osc_start(osc, 0.0);
+      }
+      ok &= expect(wajuce_context_set_render_threads(ctx, workers) == 1,
+                   "render thread count should be accepted");
+      std::vector<float> out(static_cast<size_t>(frames * channels), 0.0f);
+      wajuce_context_render(ctx, out.data(), frames, channels);
+      wajuce_context_destroy(ctx);
+      return out;
+    };
+    const auto serial = renderVoices(0);
+    const auto parallel = renderVoices(3);
+    ok &= expect(rms(serial, frames, 0) > 0.01 &&
+                     std::memcmp(serial.data(), parallel.data(),
+                                 serial.size() * sizeof(float)) == 0,
+                 "parallel rendering should be bit-identical to serial");
+  }
+
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int frames = 4096;
+    const int ctx = wajuce_context_create(sampleRate, 128, 0, 1);
+    const int first = wajuce_create_buffer_source(ctx);
+    const int second = wajuce_create_buffer_source(ctx);
+    const int convolver = wajuce_create_convolver(ctx);
+    const int gain = wajuce_create_gain(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    const float impulse[1] = {1.0f};
+    const std::vector<float> ir(600, 0.25f);
+    wajuce_buffer_source_set_buffer(first, impulse, 1, 1, sampleRate);
+    wajuce_buffer_source_set_buffer(second, impulse, 1, 1, sampleRate);
+    wajuce_convolver_set_buffer(convolver, ir.data(), 600, 1, sampleRate, 0);
+    wajuce_connect(ctx, first, convolver, 0, 0);
+    wajuce_connect(ctx, second, convolver, 0, 0);
+    wajuce_connect(ctx, convolver, gain, 0, 0);
+    wajuce_connect(ctx, gain, dest, 0, 0);
+    wajuce_buffer_source_start(first, 0.0);
+    wajuce_buffer_source_start(second, 2500.0 / sampleRate);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    ok &= expect(near(out[500], 0.25f, 0.001f) && near(out[599], 0.25f, 0.001f),
+                 "convolver tail should outlive its silent input");
+    ok &= expect(near(out[1500], 0.0f, 0.000001f) &&
+                     near(out[2600], 0.25f, 0.001f),
+                 "idle convolver should wake up when its input returns");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int frames = 2048;
+    const int ctx = wajuce_context_create(sampleRate, 128, 0, 1);
+    const int first = wajuce_create_constant_source(ctx);
+    const int second = wajuce_create_constant_source(ctx);
+    const int gain = wajuce_create_gain(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    wajuce_connect(ctx, first, gain, 0, 0);
+    wajuce_connect(ctx, second, gain, 0, 0);
+    wajuce_connect(ctx, gain, dest, 0, 0);
+    wajuce_param_set_at_time(gain, "gain", 1.0f, 0.0);
+    wajuce_param_set_target(gain, "gain", 0.0f, 128.0 / sampleRate, 0.01f);
+    wajuce_osc_start(first, 0.0);
+    wajuce_osc_stop(first, 256.0 / sampleRate);
+    wajuce_osc_start(second, 1024.0 / sampleRate);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    const auto released = [&](int frame) {
+      return static_cast<float>(
+          std::exp(-(frame - 127) / (sampleRate * 0.01)));
+    };
+    ok &= expect(near(out[600], 0.0f, 0.000001f) &&
+                     near(out[1024], released(1024), 0.001f) &&
+                     near(wajuce_param_get(gain, "gain"),
+                          released(frames - 1), 0.001f),
+                 "gain release should keep running while its input is silent");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int frames = 256;
+    const int ctx = wajuce_context_create(44100, 128, 0, 1);
+    wajuce_context_resume(ctx);
+    const int src = wajuce_create_constant_source(ctx);
+    const int gain = wajuce_create_gain(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    wajuce_param_set(src, "offset", 0.5f);
+    wajuce_connect(ctx, src, gain, 0, 0);
+    wajuce_connect(ctx, gain, dest, 0, 0);
+    wajuce_osc_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    ok &= expect(near(out[0], 0.5f, 0.001f) &&
+                     near(out[frames - 1], 0.5f, 0.001f),
+                 "queued graph commands should apply at the next block");
+    wajuce_context_remove_node(ctx, gain);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    ok &= expect(rms(out, frames, 0) < 0.000001 &&
+                     wajuce_context_get_live_node_count(ctx) == 3,
+                 "removed nodes should leave the running render graph");
+    wajuce_context_close(ctx);
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int frames = 128;
+    const int ctx = wajuce_context_create(44100, 128, 0, 1);
+    const int stale = wajuce_create_gain(ctx);
+    wajuce_context_remove_node(ctx, stale);
+    const int src = wajuce_create_constant_source(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    wajuce_param_set(src, "offset", 0.5f);
+    wajuce_connect(ctx, src, dest, 0, 0);
+    wajuce_osc_start(src, 0.0);
+    // The old handle must not reach the source, whichever slot it takes.
+    wajuce_param_set(stale, "offset", 0.0f);
+    wajuce_osc_stop(stale, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    ok &= expect(src != stale && near(out[frames - 1], 0.5f, 0.001f),
+                 "stale node handles should not reach a reused slot");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int frames = 128;
+    int ctxs[2] = {0, 0};
+    int gains[2] = {0, 0};
+    for (int i = 0; i < 2; ++i) {
+      ctxs[i] = wajuce_context_create(44100, 128, 0, 1);
+      const int src = wajuce_create_constant_source(ctxs[i]);
+      gains[i] = wajuce_create_gain(ctxs[i]);
+      wajuce_connect(ctxs[i], src, gains[i], 0, 0);
+      wajuce_connect(ctxs[i], gains[i],
+                     wajuce_context_get_destination_id(ctxs[i]), 0, 0);
+      wajuce_osc_start(src, 0.0);
+    }
+    wajuce_param_set(gains[1], "gain", 0.25f);
+    std::vector<float> first(static_cast<size_t>(frames), 0.0f);
+    std::vector<float> second(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctxs[0], first.data(), frames, 1);
+    wajuce_context_render(ctxs[1], second.data(), frames, 1);
+    ok &= expect(gains[0] != gains[1] &&
+                     near(first[frames - 1], 1.0f, 0.001f) &&
+                     near(second[frames - 1], 0.25f, 0.001f),
+                 "node handles should route to the context that owns them");
+    wajuce_context_destroy(ctxs[0]);
+    wajuce_context_destroy(ctxs[1]);
+  }
+
+  {
+    const int first = wajuce_context_create(44100, 128, 0, 1);
+    const int stale = wajuce_create_gain(first);
+    wajuce_context_destroy(first);
+    // Enough contexts to cycle through every route, each building the same
+    // graph the destroyed one did.
+    bool aliased = false;
+    for (int i = 0; i < 80; ++i) {
+      const int ctx = wajuce_context_create(44100, 128, 0, 1);
+      wajuce_create_gain(ctx);
+      aliased |= wajuce_param_get(stale, "gain") != 0.0f;
+      wajuce_context_destroy(ctx);
+    }
+    ok &= expect(!aliased, "handles from a destroyed context should not "
+                           "resolve in one that reuses its route");
+  }
+
+  {
+    constexpr int sampleRate = 1000;
+    constexpr int frames = 32;
+    const int ctx = wajuce_context_create(sampleRate, frames, 0, 1);
+    const int src = wajuce_create_buffer_source(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    std::vector<float> ramp(static_cast<size_t>(frames), 0.0f);
+    for (int i = 0; i < frames; ++i) {
+      ramp[static_cast<size_t>(i)] = static_cast<float>(i);
+    }
+    wajuce_buffer_source_set_buffer(src, ramp.data(), frames, 1, sampleRate);
+    wajuce_param_set(src, "decay", 10000.0f);
+    wajuce_connect(ctx, src, dest, 0, 0);
+    // Starts a quarter sample before frame 11 and stops halfway into frame 20.
+    wajuce_buffer_source_start(src, 0.01075);
+    wajuce_buffer_source_stop(src, 0.0205);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    ok &= expect(out[10] == 0.0f && near(out[11], 0.25f, 0.01f) &&
+                     near(out[12], 1.25f, 0.01f) &&
+                     near(out[20], 9.25f, 0.01f) && out[21] == 0.0f,
+                 "buffer sources should honour sub-sample start and stop");
+    wajuce_context_destroy(ctx);
+  }
+
   {
     constexpr int sampleRate = 44100;
     constexpr int frames = 2;
@@ -460,6 +1089,67 @@ int main() {
     wajuce_context_destroy(ctx);
   }
 
+  {
+    constexpr int channels = 1;
+    const int ctx = wajuce_context_create(44100, 8, 0, channels);
+    const int worklet = wajuce_create_worklet_bridge(ctx, 0, 1);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    wajuce_connect(ctx, worklet, dest, 0, 0);
+    std::vector<float> out(4, 1.0f);
+    wajuce_context_render(ctx, out.data(), 4, channels);
+    const float *toIsolate = wajuce_worklet_get_buffer_ptr(ctx, worklet, 0, 0);
+    ok &= expect(wajuce_worklet_get_write_pos(ctx, worklet, 0, 0) == 4 &&
+                     toIsolate != nullptr && toIsolate[0] == 0.0f &&
+                     toIsolate[3] == 0.0f,
+                 "WorkletBridge without inputs should send silence");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int frames = 128;
+    const int ctx = wajuce_context_create(44100, 128, 0, 1);
+    wajuce_context_resume(ctx);
+    const int worklet = wajuce_create_worklet_bridge(ctx, 0, 1);
+    int32_t voice[7] = {};
+    wajuce_create_machine_voice(ctx, voice);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    // The idle voice output is skipped, so the render thread steps the
+    // worklet's param timelines while new names are added from this thread.
+    wajuce_connect(ctx, worklet, voice[6], 0, 0);
+    wajuce_connect(ctx, voice[6], dest, 0, 0);
+    std::atomic<bool> rendering{true};
+    std::thread renderer([&] {
+      std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+      while (rendering.load()) {
+        wajuce_context_render(ctx, out.data(), frames, 1);
+      }
+    });
+    std::vector<int> indices;
+    for (int i = 0; i < 40; ++i) {
+      const std::string name = "p" + std::to_string(i);
+      indices.push_back(wajuce_param_get_index(worklet, name.c_str()));
+      wajuce_param_set(worklet, name.c_str(), static_cast<float>(i));
+    }
+    rendering.store(false);
+    renderer.join();
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    bool named = wajuce_param_get_index(worklet, "p3") == indices[3];
+    for (int i = 0; i < 40; ++i) {
+      const std::string name = "p" + std::to_string(i);
+      const int expected = i < 32 ? i : -1;
+      named &= indices[static_cast<size_t>(i)] == expected;
+      if (expected >= 0) {
+        named &= near(wajuce_param_get(worklet, name.c_str()),
+                      static_cast<float>(i), 1.0e-6f);
+      }
+    }
+    ok &= expect(named,
+                 "worklet params should be named while the node renders");
+    wajuce_context_close(ctx);
+    wajuce_context_destroy(ctx);
+  }
+
   {
     constexpr int sampleRate = 44100;
     constexpr int frames = 4;
@@ -643,6 +1333,173 @@ int main() {
     wajuce_context_destroy(ctx);
   }
 
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int frames = 512;
+    constexpr int irFrames = 600;
+    constexpr int channels = 2;
+    const int ctx = wajuce_context_create(sampleRate, 128, 0, channels);
+    const int src = wajuce_create_buffer_source(ctx);
+    const int conv = wajuce_create_convolver(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    // A left-only impulse through a true-stereo response: LL echoes at 300
+    // frames and LR at 200, past the directly applied head; RL and RR would
+    // only answer the silent right input.
+    const float impulse[2] = {1.0f, 0.0f};
+    std::vector<float> ir(static_cast<size_t>(irFrames * 4), 0.0f);
+    ir[300] = 1.0f;
+    ir[irFrames + 200] = 0.5f;
+    ir[irFrames * 2 + 100] = 1.0f;
+    ir[irFrames * 3 + 100] = 1.0f;
+    wajuce_buffer_source_set_buffer(src, impulse, 1, 2, sampleRate);
+    wajuce_param_set(src, "decay", 10000.0f);
+    wajuce_convolver_set_buffer(conv, ir.data(), irFrames, 4, sampleRate, 0);
+    wajuce_connect(ctx, src, conv, 0, 0);
+    wajuce_connect(ctx, conv, dest, 0, 0);
+    wajuce_buffer_source_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames * channels), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, channels);
+    ok &= expect(peakIndex(out, frames, 0) == 300 &&
+                     near(out[300], 1.0f, 0.001f) &&
+                     peakIndex(out, frames, 1) == 200 &&
+                     near(out[frames + 200], 0.5f, 0.001f) &&
+                     std::abs(out[100]) < 0.001f &&
+                     std::abs(out[frames + 100]) < 0.001f,
+                 "convolver should route true-stereo responses");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int frames = 512;
+    const int ctx = wajuce_context_create(sampleRate, 128, 0, 1);
+    const int src = wajuce_create_buffer_source(ctx);
+    const int conv = wajuce_create_convolver(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    const float impulse[1] = {1.0f};
+    // An echo 100 frames in at half the context rate lands at frame 200.
+    std::vector<float> ir(150, 0.0f);
+    ir[100] = 1.0f;
+    wajuce_buffer_source_set_buffer(src, impulse, 1, 1, sampleRate);
+    wajuce_param_set(src, "decay", 10000.0f);
+    wajuce_convolver_set_buffer(conv, ir.data(), 150, 1, sampleRate / 2, 0);
+    wajuce_connect(ctx, src, conv, 0, 0);
+    wajuce_connect(ctx, conv, dest, 0, 0);
+    wajuce_buffer_source_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    ok &= expect(peakIndex(out, frames, 0) == 200 &&
+                     near(out[200], 1.0f, 0.05f),
+                 "convolver should resample responses to the context rate");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int frames = 4096;
+    const int ctx = wajuce_context_create(44100, 128, 0, 1);
+    const int src = wajuce_create_constant_source(ctx);
+    const int conv = wajuce_create_convolver(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    const float unity[1] = {1.0f};
+    const float silent[1] = {0.0f};
+    wajuce_convolver_set_buffer(conv, unity, 1, 1, 44100, 0);
+    wajuce_connect(ctx, src, conv, 0, 0);
+    wajuce_connect(ctx, conv, dest, 0, 0);
+    wajuce_osc_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), 256, 1);
+    wajuce_convolver_set_buffer(conv, silent, 1, 1, 44100, 0);
+    wajuce_context_render(ctx, out.data(), frames, 1);
+    ok &= expect(near(out[0], 1.0f, 0.001f) && out[1100] > 0.5f &&
+                     out[1100] < 0.9f && std::abs(out[frames - 1]) < 0.001f,
+                 "convolver should crossfade to a new response");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int frames = 5376;
+    const int ctx = wajuce_context_create(44100, 128, 0, 1);
+    const int src = wajuce_create_constant_source(ctx);
+    const int conv = wajuce_create_convolver(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    const float unity[1] = {1.0f};
+    const float half[1] = {0.5f};
+    const float silent[1] = {0.0f};
+    wajuce_convolver_set_buffer(conv, unity, 1, 1, 44100, 0);
+    wajuce_connect(ctx, src, conv, 0, 0);
+    wajuce_connect(ctx, conv, dest, 0, 0);
+    wajuce_osc_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), 256, 1);
+    wajuce_convolver_set_buffer(conv, half, 1, 1, 44100, 0);
+    wajuce_context_render(ctx, out.data() + 256, 1024, 1);
+    // The second change lands halfway through the first crossfade, which
+    // has to finish before the next one starts.
+    wajuce_convolver_set_buffer(conv, silent, 1, 1, 44100, 0);
+    wajuce_context_render(ctx, out.data() + 1280, frames - 1280, 1);
+    float largestStep = 0.0f;
+    for (size_t i = 1; i < out.size(); ++i) {
+      largestStep = std::max(largestStep, std::abs(out[i] - out[i - 1]));
+    }
+    ok &= expect(largestStep < 0.01f && near(out[2500], 0.5f, 0.001f) &&
+                     std::abs(out[frames - 1]) < 0.001f,
+                 "convolver should finish a crossfade before starting another");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int frames = 128;
+    const int ctx = wajuce_context_create(44100, 128, 0, 1);
+    wajuce_context_resume(ctx);
+    const int src = wajuce_create_constant_source(ctx);
+    const int conv = wajuce_create_convolver(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    const float ir[1] = {0.5f};
+    wajuce_connect(ctx, src, conv, 0, 0);
+    wajuce_connect(ctx, conv, dest, 0, 0);
+    wajuce_osc_start(src, 0.0);
+    // A running context prepares the response on its worker; it arrives a
+    // few blocks later without the caller waiting.
+    wajuce_convolver_set_buffer(conv, ir, 1, 1, 44100, 0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    bool arrived = false;
+    for (int attempt = 0; attempt < 500 && !arrived; ++attempt) {
+      wajuce_context_render(ctx, out.data(), frames, 1);
+      arrived = near(out[frames - 1], 0.5f, 0.001f);
+      if (!arrived) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+    ok &= expect(arrived, "running contexts should prepare responses off the "
+                          "calling thread");
+    wajuce_context_close(ctx);
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int frames = 128;
+    const int ctx = wajuce_context_create(44100, 128, 0, 2);
+    const int src = wajuce_create_constant_source(ctx);
+    const int conv = wajuce_create_convolver(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    const float ir[1] = {0.5f};
+    wajuce_convolver_set_buffer(conv, ir, 1, 1, 44100, 0);
+    wajuce_connect(ctx, src, conv, 0, 0);
+    wajuce_connect(ctx, conv, dest, 0, 0);
+    wajuce_osc_start(src, 0.0);
+    // The response was partitioned for two channels; rendering one has to
+    // re-prepare it before the block instead of inside it.
+    std::vector<float> mono(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, mono.data(), frames, 1);
+    std::vector<float> stereo(static_cast<size_t>(frames * 2), 0.0f);
+    wajuce_context_render(ctx, stereo.data(), frames, 2);
+    ok &= expect(near(mono[frames - 1], 0.5f, 0.001f) &&
+                     near(stereo[frames - 1], 0.5f, 0.001f) &&
+                     near(stereo[frames * 2 - 1], 0.5f, 0.001f),
+                 "convolver should follow the render channel count");
+    wajuce_context_destroy(ctx);
+  }
+
   {
     constexpr int sampleRate = 44100;
     constexpr int frames = 4;
@@ -695,6 +1552,40 @@ int main() {
     wajuce_context_destroy(ctx);
   }
 
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int frames = 4096;
+    std::vector<float> held(static_cast<size_t>(frames), 0.0f);
+    std::vector<float> swept(static_cast<size_t>(frames), 0.0f);
+    for (int pass = 0; pass < 2; ++pass) {
+      const int ctx = wajuce_context_create(sampleRate, 128, 0, 1);
+      const int osc = wajuce_create_oscillator(ctx);
+      const int biquad = wajuce_create_biquad_filter(ctx);
+      const int dest = wajuce_context_get_destination_id(ctx);
+      wajuce_param_set(osc, "frequency", 1000.0f);
+      if (pass == 0) {
+        wajuce_param_set(biquad, "frequency", 2000.0f);
+      } else {
+        wajuce_param_set_at_time(biquad, "frequency", 200.0f, 0.0);
+        wajuce_param_linear_ramp(biquad, "frequency", 2000.0f,
+                                 300.0 / sampleRate);
+      }
+      wajuce_connect(ctx, osc, biquad, 0, 0);
+      wajuce_connect(ctx, biquad, dest, 0, 0);
+      wajuce_osc_start(osc, 0.0);
+      wajuce_context_render(ctx, pass == 0 ? held.data() : swept.data(),
+                            frames, 1);
+      wajuce_context_destroy(ctx);
+    }
+    float maxDiff = 0.0f;
+    for (int i = frames - 1024; i < frames; ++i) {
+      maxDiff = std::max(maxDiff, std::abs(held[static_cast<size_t>(i)] -
+                                           swept[static_cast<size_t>(i)]));
+    }
+    ok &= expect(rms(swept, 256, 0) > 0.0 && maxDiff < 0.001f,
+                 "automated biquad should settle onto the held response");
+  }
+
   {
     constexpr int sampleRate = 44100;
     constexpr int frames = 2048;
@@ -717,6 +1608,176 @@ int main() {
     wajuce_context_destroy(ctx);
   }
 
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int frames = 1024;
+    constexpr int channels = 2;
+    const int ctx = wajuce_context_create(sampleRate, 128, 0, channels);
+    const int src = wajuce_create_buffer_source(ctx);
+    const int comp = wajuce_create_compressor(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    std::vector<float> stereo(static_cast<size_t>(frames * channels), 1.0f);
+    std::fill(stereo.begin() + frames, stereo.end(), 0.1f);
+    wajuce_buffer_source_set_buffer(src, stereo.data(), frames, channels,
+                                    sampleRate);
+    wajuce_param_set(src, "decay", 10000.0f);
+    wajuce_connect(ctx, src, comp, 0, 0);
+    wajuce_connect(ctx, comp, dest, 0, 0);
+    wajuce_buffer_source_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames * channels), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, channels);
+    bool linked = true;
+    for (int i = 0; i < frames; ++i) {
+      linked &= near(out[static_cast<size_t>(frames + i)],
+                     0.1f * out[static_cast<size_t>(i)], 1e-5f);
+    }
+    ok &= expect(linked && out[frames - 1] < 0.5f,
+                 "compressor should apply one linked gain to every channel");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int sampleRate = 48000;
+    constexpr int frames = 512;
+    constexpr int channels = 1;
+    constexpr int lookahead = 240;
+    const int ctx = wajuce_context_create(sampleRate, 128, 0, channels);
+    const int src = wajuce_create_buffer_source(ctx);
+    const int comp = wajuce_create_compressor(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    std::vector<float> loud(static_cast<size_t>(frames), 1.0f);
+    wajuce_buffer_source_set_buffer(src, loud.data(), frames, 1, sampleRate);
+    wajuce_param_set(src, "decay", 10000.0f);
+    wajuce_param_set(comp, "attack", 0.001f);
+    wajuce_compressor_set_lookahead(
+        comp, static_cast<double>(lookahead) / sampleRate);
+    wajuce_connect(ctx, src, comp, 0, 0);
+    wajuce_connect(ctx, comp, dest, 0, 0);
+    wajuce_buffer_source_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, channels);
+    ok &= expect(out[lookahead - 1] == 0.0f && out[lookahead] > 0.0f &&
+                     out[lookahead] < 0.2f,
+                 "compressor lookahead should reduce gain before the onset");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    constexpr int sampleRate = 48000;
+    constexpr int frames = 512;
+    constexpr int channels = 2;
+    constexpr int lookahead = 240;
+    // Created mono and rendered in stereo: both channels must be delayed.
+    const int ctx = wajuce_context_create(sampleRate, 128, 0, 1);
+    const int src = wajuce_create_buffer_source(ctx);
+    const int comp = wajuce_create_compressor(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    std::vector<float> loud(static_cast<size_t>(frames * channels), 1.0f);
+    wajuce_buffer_source_set_buffer(src, loud.data(), frames, channels,
+                                    sampleRate);
+    wajuce_param_set(src, "decay", 10000.0f);
+    wajuce_compressor_set_lookahead(
+        comp, static_cast<double>(lookahead) / sampleRate);
+    wajuce_connect(ctx, src, comp, 0, 0);
+    wajuce_connect(ctx, comp, dest, 0, 0);
+    wajuce_buffer_source_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames * channels), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, channels);
+    ok &= expect(out[lookahead - 1] == 0.0f &&
+                     out[frames + lookahead - 1] == 0.0f &&
+                     out[frames + lookahead] > 0.0f,
+                 "compressor lookahead should delay every rendered channel");
+    wajuce_context_destroy(ctx);
+  }
+
+  {
+    // Every kernel set this CPU supports must agree with the scalar one,
+    // including the tails left over after the vector loops.
+    const auto &reference = wajuce::vec::scalar::kernels();
+    constexpr int count = 37;
+    std::vector<float> a(static_cast<size_t>(count * 2));
+    std::vector<float> b(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+      a[i] = std::sin(0.37f * static_cast<float>(i)) * 1.5f;
+      b[i] = std::cos(0.11f * static_cast<float>(i)) - 0.25f;
+    }
+    const auto same = [&](const std::vector<float> &x,
+                          const std::vector<float> &y) {
+      for (size_t i = 0; i < x.size(); ++i) {
+        if (!near(x[i], y[i], 1.0e-6f * std::max(1.0f, std::abs(y[i])))) {
+          return false;
+        }
+      }
+      return true;
+    };
+    bool agrees = true;
+    for (const auto *kernels : wajuce::vec::supportedKernels()) {
+      for (const int n : {0, 1, 3, 4, 7, 8, 9, 16, count}) {
+        const auto run = [&](const wajuce::vec::Kernels &k) {
+          std::vector<float> out(b);
+          k.add(a.data(), out.data(), n);
+          k.multiply(a.data() + 1, out.data(), n);
+          k.multiplyAdd(a.data() + 2, -0.75f, out.data(), n);
+          k.scale(out.data(), 1.25f, out.data(), n);
+          k.clamp(out.data(), -1.0f, 1.0f, n);
+          out.push_back(k.peak(a.data() + 3, n));
+          out.push_back(k.sumOfSquares(b.data() + 1, n));
+          return out;
+        };
+        agrees &= same(run(*kernels), run(reference));
+        for (const int channels : {1, 2, 3}) {
+          std::vector<float> woven(a.size(), 0.0f);
+          std::vector<float> expected(a.size(), 0.0f);
+          const int frames = std::min(n, count * 2 / channels);
+          kernels->interleave(a.data(), frames, channels, woven.data());
+          reference.interleave(a.data(), frames, channels, expected.data());
+          agrees &= woven == expected;
+          kernels->deinterleave(b.data(), frames, channels, woven.data());
+          reference.deinterleave(b.data(), frames, channels, expected.data());
+          agrees &= woven == expected;
+        }
+      }
+    }
+    ok &= expect(agrees, "vector kernels should match the scalar kernels");
+    std::vector<float> mixed = {-3.0f, std::nanf(""), 0.5f, 2.0f, -0.25f};
+    wajuce::vec::clamp(mixed.data(), -1.0f, 1.0f, 5);
+    const float level = wajuce::vec::rms(mixed.data() + 2, 2);
+    ok &= expect(mixed[0] == -1.0f && mixed[1] == 1.0f && mixed[3] == 1.0f &&
+                     near(level, 0.7906f, 1e-4f),
+                 "vector clamp should follow clampFloat, NaN included");
+  }
+
+  {
+    constexpr int sampleRate = 44100;
+    constexpr int frames = 128;
+    constexpr int channels = 2;
+    const int ctx = wajuce_context_create(sampleRate, 128, 0, channels);
+    const int src = wajuce_create_constant_source(ctx);
+    const int fixed = wajuce_create_stereo_panner(ctx);
+    const int swept = wajuce_create_stereo_panner(ctx);
+    const int dest = wajuce_context_get_destination_id(ctx);
+    wajuce_param_set(src, "offset", 0.5f);
+    wajuce_param_set(fixed, "pan", 0.5f);
+    wajuce_param_set_at_time(swept, "pan", -1.0f, 0.0);
+    wajuce_param_linear_ramp(swept, "pan", 1.0f,
+                             static_cast<double>(frames - 1) / sampleRate);
+    wajuce_connect(ctx, src, fixed, 0, 0);
+    wajuce_connect(ctx, src, swept, 0, 0);
+    wajuce_connect(ctx, fixed, dest, 0, 0);
+    wajuce_connect(ctx, swept, dest, 0, 0);
+    wajuce_osc_start(src, 0.0);
+    std::vector<float> out(static_cast<size_t>(frames * channels), 0.0f);
+    wajuce_context_render(ctx, out.data(), frames, channels);
+    const float left = 0.5f * std::cos(0.375f * 3.14159265f);
+    const float right = 0.5f * std::sin(0.375f * 3.14159265f);
+    ok &= expect(near(out[0], left + 0.5f, 1e-3f) &&
+                     near(out[frames], right, 1e-3f) &&
+                     near(out[frames - 1], left, 1e-3f) &&
+                     near(out[2 * frames - 1], right + 0.5f, 1e-3f),
+                 "StereoPannerNode should follow constant and ramped pans");
+    wajuce_context_destroy(ctx);
+  }
+
   {
     constexpr int sampleRate = 44100;
     constexpr int frames = 128;
@@ -60,6 +60,11 @@ wajuce_context_set_preferred_bit_depth(int32_t ctx_id,
   return 0;
 }
 
+FFI_PLUGIN_EXPORT int32_t
+wajuce_context_set_render_threads(int32_t ctx_id, int32_t worker_threads) {
+  return 0;
+}
+
 FFI_PLUGIN_EXPORT int32_t wajuce_context_get_state(int32_t ctx_id) { return 0; }
 
 FFI_PLUGIN_EXPORT void wajuce_context_resume(int32_t ctx_id) {}
@@ -249,6 +254,63 @@ FFI_PLUGIN_EXPORT float wajuce_param_get(int32_t node_id, const char *param) {
   return 0.0f;
 }
 
+FFI_PLUGIN_EXPORT int32_t wajuce_param_set_automation_rate(int32_t node_id,
+                                                           const char *param,
+                                                           int32_t rate) {
+  return 0;
+}
+
+FFI_PLUGIN_EXPORT int32_t wajuce_param_get_index(int32_t node_id,
+                                               const char *param) {
+  return -1;
+}
+
+FFI_PLUGIN_EXPORT void wajuce_param_set_by_index(int32_t node_id,
+                                                 int32_t index, float value) {}
+
+FFI_PLUGIN_EXPORT void wajuce_param_set_at_time_by_index(int32_t node_id,
+                                                         int32_t index,
+                                                         float value,
+                                                         double time) {}
+
+FFI_PLUGIN_EXPORT void wajuce_param_linear_ramp_by_index(int32_t node_id,
+                                                         int32_t index,
+                                                         float value,
+                                                         double end_time) {}
+
+FFI_PLUGIN_EXPORT void wajuce_param_exp_ramp_by_index(int32_t node_id,
+                                                      int32_t index,
+                                                      float value,
+                                                      double end_time) {}
+
+FFI_PLUGIN_EXPORT void wajuce_param_set_target_by_index(int32_t node_id,
+                                                        int32_t index,
+                                                        float target,
+                                                        double start_time,
+                                                        float tc) {}
+
+FFI_PLUGIN_EXPORT void wajuce_param_set_value_curve_by_index(
+    int32_t node_id, int32_t index, const float *values, int32_t length,
+    double start_time, double duration) {}
+
+FFI_PLUGIN_EXPORT void wajuce_param_cancel_by_index(int32_t node_id,
+                                                    int32_t index,
+                                                    double cancel_time) {}
+
+FFI_PLUGIN_EXPORT void wajuce_param_cancel_and_hold_by_index(int32_t node_id,
+                                                             int32_t index,
+                                                             double time) {}
+
+FFI_PLUGIN_EXPORT float wajuce_param_get_by_index(int32_t node_id,
+                                                  int32_t index) {
+  return 0.0f;
+}
+
+FFI_PLUGIN_EXPORT int32_t wajuce_param_set_automation_rate_by_index(
+    int32_t node_id, int32_t index, int32_t rate) {
+  return 0;
+}
+
 // ============================================================================
 // Oscillator
 // ============================================================================
@@ -355,6 +417,8 @@ FFI_PLUGIN_EXPORT void wajuce_iir_get_frequency_response(
 FFI_PLUGIN_EXPORT float wajuce_compressor_get_reduction(int32_t node_id) {
   return 0.0f;
 }
+FFI_PLUGIN_EXPORT void wajuce_compressor_set_lookahead(int32_t node_id,
+                                                       double seconds) {}
 
 FFI_PLUGIN_EXPORT void wajuce_panner_set_panning_model(int32_t node_id,
                                                        int32_t model) {}
@@ -43,6 +43,8 @@ wajuce_context_set_preferred_sample_rate(int32_t ctx_id,
 FFI_PLUGIN_EXPORT int32_t
 wajuce_context_set_preferred_bit_depth(int32_t ctx_id,
                                        int32_t preferred_bit_depth);
+FFI_PLUGIN_EXPORT int32_t
+wajuce_context_set_render_threads(int32_t ctx_id, int32_t worker_threads);
 FFI_PLUGIN_EXPORT int32_t wajuce_context_get_state(int32_t ctx_id);
 FFI_PLUGIN_EXPORT void wajuce_context_resume(int32_t ctx_id);
 FFI_PLUGIN_EXPORT void wajuce_context_suspend(int32_t ctx_id);
@@ -145,6 +147,49 @@ FFI_PLUGIN_EXPORT void wajuce_param_cancel_and_hold(int32_t node_id,
                                                     const char *param,
                                                     double time);
 FFI_PLUGIN_EXPORT float wajuce_param_get(int32_t node_id, const char *param);
+// AudioParam.automationRate: 0 = "a-rate", 1 = "k-rate". Returns 1 when the
+// param now has that rate, 0 when it is unknown or its rate is fixed.
+FFI_PLUGIN_EXPORT int32_t wajuce_param_set_automation_rate(int32_t node_id,
+                                                           const char *param,
+                                                           int32_t rate);
+
+// Index-based variants. `wajuce_param_get_index` resolves a param name to the
+// slot its node kind registers it in (-1 if unknown); the index stays valid
+// for the lifetime of the node.
+FFI_PLUGIN_EXPORT int32_t wajuce_param_get_index(int32_t node_id,
+                                               const char *param);
+FFI_PLUGIN_EXPORT void wajuce_param_set_by_index(int32_t node_id,
+                                                 int32_t index, float value);
+FFI_PLUGIN_EXPORT void wajuce_param_set_at_time_by_index(int32_t node_id,
+                                                         int32_t index,
+                                                         float value,
+                                                         double time);
+FFI_PLUGIN_EXPORT void wajuce_param_linear_ramp_by_index(int32_t node_id,
+                                                         int32_t index,
+                                                         float value,
+                                                         double end_time);
+FFI_PLUGIN_EXPORT void wajuce_param_exp_ramp_by_index(int32_t node_id,
+                                                      int32_t index,
+                                                      float value,
+                                                      double end_time);
+FFI_PLUGIN_EXPORT void wajuce_param_set_target_by_index(int32_t node_id,
+                                                        int32_t index,
+                                                        float target,
+                                                        double start_time,
+                                                        float tc);
+FFI_PLUGIN_EXPORT void wajuce_param_set_value_curve_by_index(
+    int32_t node_id, int32_t index, const float *values, int32_t length,
+    double start_time, double duration);
+FFI_PLUGIN_EXPORT void wajuce_param_cancel_by_index(int32_t node_id,
+                                                    int32_t index,
+                                                    double cancel_time);
+FFI_PLUGIN_EXPORT void wajuce_param_cancel_and_hold_by_index(int32_t node_id,
+                                                             int32_t index,
+                                                             double time);
+FFI_PLUGIN_EXPORT float wajuce_param_get_by_index(int32_t node_id,
+                                                  int32_t index);
+FFI_PLUGIN_EXPORT int32_t wajuce_param_set_automation_rate_by_index(
+    int32_t node_id, int32_t index, int32_t rate);
 
 // ============================================================================
 // Oscillator
@@ -207,6 +252,10 @@ FFI_PLUGIN_EXPORT void wajuce_iir_get_frequency_response(
     int32_t node_id, const float *frequency_hz, float *mag_response,
     float *phase_response, int32_t len);
 FFI_PLUGIN_EXPORT float wajuce_compressor_get_reduction(int32_t node_id);
+// Delays the compressed signal behind its detector by up to 0.1 s, so gain
+// reduction is in place when a transient arrives. Defaults to 0.
+FFI_PLUGIN_EXPORT void wajuce_compressor_set_lookahead(int32_t node_id,
+                                                       double seconds);
 
 // ============================================================================
 // PannerNode